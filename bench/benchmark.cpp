@@ -0,0 +1,810 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "collision_grid.h"
+#include "entities.h"
+#include "job_system.h"
+#include "random.h"
+#include "sprite_batch.h"
+
+// Microbenchmarks for the simulation hot paths, built apart from the game with `make bench`.
+// Every benchmark runs `warmup` untimed repetitions and then `repetitions` timed ones. A repetition
+// performs `batch` operations (one wave created, one tick moved, one compaction...) so that small
+// entity counts still span many timer ticks, and every time is reported per operation.
+
+typedef struct
+{
+    int warmup;
+    int repetitions;
+    const char *filter;
+    std::vector<int> entityCounts;
+} BenchmarkOptions;
+
+typedef struct
+{
+    double min;
+    double median;
+    double mean;
+    double standardDeviation;
+    double max;
+} BenchmarkStats;
+
+const int DEFAULT_ENTITY_COUNTS[] = {55, 1000, 10000, 55000, 100000};
+
+// a repetition touches about this many entities, so the batch shrinks as the count grows.
+const int ENTITIES_PER_REPETITION = 1 << 18;
+
+// the legacy erase based removal is quadratic, it is skipped above this count.
+const int LEGACY_ERASE_LIMIT = 10000;
+
+// synthetic waves are a square-ish grid of small aliens, at least as wide as the real 11 columns.
+const int SLOT_PITCH = 12;
+const int ALIEN_SIZE = 8;
+
+const int LASERS_PER_TICK = 256;
+
+// share of the entities destroyed before each compaction.
+const float DESTROYED_FRACTION = 0.1f;
+
+// The array-of-structures layout the game used before AlienStore/LaserStore, kept as the baseline.
+typedef struct
+{
+    float x;
+    Sprite sprite;
+    int points;
+    int velocity;
+    bool isDestroyed;
+} LegacyAlien;
+
+typedef struct
+{
+    SDL_Rect bounds;
+    bool isDestroyed;
+} LegacyLaser;
+
+typedef struct
+{
+    int columns;
+    int rows;
+    int width;
+    int height;
+} WaveLayout;
+
+// restarted with every thread count of the laser pass benchmark.
+JobSystem benchmarkJobs;
+
+// results are accumulated here so the optimizer cannot drop the measured work.
+volatile int benchmarkSink;
+
+static BenchmarkStats computeStats(std::vector<double> &samples)
+{
+    BenchmarkStats stats;
+
+    std::sort(samples.begin(), samples.end());
+
+    size_t count = samples.size();
+    double sum = 0;
+
+    for (double sample : samples)
+    {
+        sum += sample;
+    }
+
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.mean = sum / count;
+    stats.median = count % 2 == 1 ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2;
+
+    double squares = 0;
+
+    for (double sample : samples)
+    {
+        squares += (sample - stats.mean) * (sample - stats.mean);
+    }
+
+    stats.standardDeviation = count > 1 ? SDL_sqrt(squares / (count - 1)) : 0;
+
+    return stats;
+}
+
+// setup prepares `batch` operations outside the timed region, run performs them.
+static void runBenchmark(const BenchmarkOptions &options, const char *name, int entities, const std::function<void(int)> &setup, const std::function<void(int)> &run)
+{
+    if (options.filter != nullptr && SDL_strstr(name, options.filter) == nullptr)
+    {
+        return;
+    }
+
+    int batch = std::max(1, ENTITIES_PER_REPETITION / entities);
+
+    double frequency = (double)SDL_GetPerformanceFrequency();
+
+    std::vector<double> samples;
+    samples.reserve(options.repetitions);
+
+    for (int repetition = 0; repetition < options.warmup + options.repetitions; repetition++)
+    {
+        setup(batch);
+
+        Uint64 start = SDL_GetPerformanceCounter();
+
+        run(batch);
+
+        Uint64 end = SDL_GetPerformanceCounter();
+
+        if (repetition >= options.warmup)
+        {
+            samples.push_back((end - start) * 1000000.0 / frequency / batch);
+        }
+    }
+
+    BenchmarkStats stats = computeStats(samples);
+
+    printf("%-36s %8d %6d %11.3f %11.3f %11.3f %10.3f %11.3f %10.2f\n", name, entities, batch, stats.min, stats.median, stats.mean, stats.standardDeviation, stats.max, stats.median * 1000.0 / entities);
+}
+
+static void noSetup(int)
+{
+}
+
+static WaveLayout getWaveLayout(int entities)
+{
+    WaveLayout layout;
+
+    layout.columns = std::max(11, (int)SDL_ceil(SDL_sqrt(entities)));
+    layout.rows = (entities + layout.columns - 1) / layout.columns;
+    layout.width = layout.columns * SLOT_PITCH;
+    layout.height = layout.rows * SLOT_PITCH;
+
+    return layout;
+}
+
+// same fill as the game's createAliens: clear in place, reserve, then one addAlien per slot.
+static void createAliens(AlienStore &aliens, const WaveLayout &layout, int entities)
+{
+    clearAliens(aliens);
+    reserveAliens(aliens, entities);
+
+    for (int i = 0; i < entities; i++)
+    {
+        int row = i / layout.columns;
+        int column = i % layout.columns;
+
+        addAlien(aliens, column * SLOT_PITCH, row * SLOT_PITCH, ALIEN_SIZE, ALIEN_SIZE, 8 - row % 5, (Uint8)(row % 3));
+    }
+}
+
+static void createLegacyAliens(std::vector<LegacyAlien> &aliens, const WaveLayout &layout, int entities)
+{
+    aliens.clear();
+    aliens.reserve(entities);
+
+    for (int i = 0; i < entities; i++)
+    {
+        int x = (i % layout.columns) * SLOT_PITCH;
+        int y = (i / layout.columns) * SLOT_PITCH;
+
+        Sprite sprite = {nullptr, {x, y, ALIEN_SIZE, ALIEN_SIZE}, {0, 0, ALIEN_SIZE, ALIEN_SIZE}};
+
+        aliens.push_back({(float)x, sprite, 8 - (i / layout.columns) % 5, 100, false});
+    }
+}
+
+static void destroySome(std::vector<Uint8> &isDestroyed, Random &random)
+{
+    for (Uint8 &destroyed : isDestroyed)
+    {
+        destroyed = nextRandomBounded(random, 1000) < DESTROYED_FRACTION * 1000;
+    }
+}
+
+static std::vector<SDL_Rect> createLaserBounds(int count, int width, int height, Random &random)
+{
+    std::vector<SDL_Rect> bounds(count);
+
+    for (SDL_Rect &laser : bounds)
+    {
+        laser = {(int)nextRandomBounded(random, width), (int)nextRandomBounded(random, height), 4, 16};
+    }
+
+    return bounds;
+}
+
+// four structures along the bottom of the wave, like the shields under the real formation.
+static std::vector<SDL_Rect> createStructures(const WaveLayout &layout)
+{
+    std::vector<SDL_Rect> structures;
+
+    for (int i = 0; i < 4; i++)
+    {
+        structures.push_back({layout.width * (2 * i + 1) / 8 - 28, layout.height - 33, 56, 33});
+    }
+
+    return structures;
+}
+
+static int checkStructures(const std::vector<SDL_Rect> &structures, const SDL_Rect &laser)
+{
+    for (const SDL_Rect &structure : structures)
+    {
+        if (SDL_HasIntersection(&structure, &laser))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void benchmarkCreateAliens(const BenchmarkOptions &options, int entities)
+{
+    WaveLayout layout = getWaveLayout(entities);
+
+    AlienStore aliens;
+    std::vector<LegacyAlien> legacyAliens;
+
+    runBenchmark(options, "createAliens/legacy-aos", entities, noSetup, [&](int batch) {
+        for (int i = 0; i < batch; i++)
+        {
+            createLegacyAliens(legacyAliens, layout, entities);
+        }
+
+        benchmarkSink += (int)legacyAliens.size();
+    });
+
+    runBenchmark(options, "createAliens/soa", entities, noSetup, [&](int batch) {
+        for (int i = 0; i < batch; i++)
+        {
+            createAliens(aliens, layout, entities);
+        }
+
+        benchmarkSink += (int)alienCount(aliens);
+    });
+}
+
+static void benchmarkAliensMovement(const BenchmarkOptions &options, int entities)
+{
+    const float deltaTime = 1.0f / 120.0f;
+
+    WaveLayout layout = getWaveLayout(entities);
+
+    // leaves room for the wave to travel, so some ticks bounce off the edges.
+    int screenWidth = layout.width + 200;
+
+    std::vector<LegacyAlien> legacyAliens;
+    createLegacyAliens(legacyAliens, layout, entities);
+
+    // the legacy per-alien update, unchanged except for the screen width.
+    runBenchmark(options, "aliensMovement/legacy-aos", entities, noSetup, [&](int batch) {
+        for (int tick = 0; tick < batch; tick++)
+        {
+            bool shouldChangeVelocity = false;
+
+            for (LegacyAlien &alien : legacyAliens)
+            {
+                alien.x += alien.velocity * deltaTime;
+                alien.sprite.textureBounds.x = alien.x;
+
+                float alienPosition = alien.sprite.textureBounds.x + alien.sprite.textureBounds.w;
+
+                if ((!shouldChangeVelocity && alienPosition > screenWidth) || alienPosition < alien.sprite.textureBounds.w)
+                {
+                    shouldChangeVelocity = true;
+                    break;
+                }
+            }
+
+            if (shouldChangeVelocity)
+            {
+                for (LegacyAlien &alien : legacyAliens)
+                {
+                    alien.velocity *= -1;
+                    alien.sprite.textureBounds.y += 10;
+                }
+            }
+        }
+
+        benchmarkSink += legacyAliens[0].sprite.textureBounds.x;
+    });
+
+    // the same per-alien sweep over separate columns, isolates the layout from the formation.
+    std::vector<float> x(entities);
+    std::vector<int> boundsX(entities);
+    std::vector<int> w(entities, ALIEN_SIZE);
+    int velocity = 100;
+
+    for (int i = 0; i < entities; i++)
+    {
+        x[i] = (float)legacyAliens[i].sprite.textureBounds.x;
+    }
+
+    runBenchmark(options, "aliensMovement/soa-sweep", entities, noSetup, [&](int batch) {
+        for (int tick = 0; tick < batch; tick++)
+        {
+            bool shouldChangeVelocity = false;
+
+            for (int i = 0; i < entities; i++)
+            {
+                x[i] += velocity * deltaTime;
+                boundsX[i] = (int)x[i];
+
+                int alienPosition = boundsX[i] + w[i];
+
+                shouldChangeVelocity |= alienPosition > screenWidth || alienPosition < w[i];
+            }
+
+            if (shouldChangeVelocity)
+            {
+                velocity *= -1;
+            }
+        }
+
+        benchmarkSink += boundsX[0];
+    });
+
+    AlienStore aliens;
+    Formation formation;
+
+    createAliens(aliens, layout, entities);
+    setupFormation(formation, aliens, layout.columns, 100);
+
+    runBenchmark(options, "aliensMovement/formation", entities, noSetup, [&](int batch) {
+        for (int tick = 0; tick < batch; tick++)
+        {
+            moveFormation(formation, deltaTime, screenWidth);
+        }
+
+        benchmarkSink += getFormationOffsetX(formation);
+    });
+}
+
+static void benchmarkCollisions(const BenchmarkOptions &options, int entities)
+{
+    WaveLayout layout = getWaveLayout(entities);
+
+    Random random;
+    seedRandom(random, 1, 0);
+
+    AlienStore aliens;
+    createAliens(aliens, layout, entities);
+    destroySome(aliens.isDestroyed, random);
+
+    std::vector<LegacyAlien> legacyAliens;
+    createLegacyAliens(legacyAliens, layout, entities);
+
+    for (int i = 0; i < entities; i++)
+    {
+        legacyAliens[i].isDestroyed = aliens.isDestroyed[i];
+    }
+
+    std::vector<SDL_Rect> lasers = createLaserBounds(LASERS_PER_TICK, layout.width, layout.height, random);
+    std::vector<SDL_Rect> structures = createStructures(layout);
+
+    // hits are only counted, nothing is destroyed, so every tick tests the same wave.
+    runBenchmark(options, "collisions/legacy-aos", entities, noSetup, [&](int batch) {
+        int hits = 0;
+
+        for (int tick = 0; tick < batch; tick++)
+        {
+            for (const SDL_Rect &laser : lasers)
+            {
+                for (const LegacyAlien &alien : legacyAliens)
+                {
+                    if (!alien.isDestroyed && SDL_HasIntersection(&alien.sprite.textureBounds, &laser))
+                    {
+                        hits++;
+                        break;
+                    }
+                }
+
+                hits += checkStructures(structures, laser);
+            }
+        }
+
+        benchmarkSink += hits;
+    });
+
+    runBenchmark(options, "collisions/soa-brute-force", entities, noSetup, [&](int batch) {
+        int hits = 0;
+
+        for (int tick = 0; tick < batch; tick++)
+        {
+            for (const SDL_Rect &laser : lasers)
+            {
+                for (int i = 0; i < entities; i++)
+                {
+                    if (!aliens.isDestroyed[i] && hasIntersection(aliens.x[i], aliens.y[i], aliens.w[i], aliens.h[i], laser))
+                    {
+                        hits++;
+                        break;
+                    }
+                }
+
+                hits += checkStructures(structures, laser);
+            }
+        }
+
+        benchmarkSink += hits;
+    });
+
+    CollisionGrid grid;
+    setupCollisionGrid(grid, layout.width, layout.height, 64);
+
+    runBenchmark(options, "collisions/grid-build", entities, noSetup, [&](int batch) {
+        for (int i = 0; i < batch; i++)
+        {
+            buildCollisionGrid(grid, aliens);
+        }
+
+        benchmarkSink += (int)grid.cellItems.size();
+    });
+
+    runBenchmark(options, "collisions/grid", entities, noSetup, [&](int batch) {
+        int hits = 0;
+
+        for (int tick = 0; tick < batch; tick++)
+        {
+            for (const SDL_Rect &laser : lasers)
+            {
+                hits += findAlienCollision(grid, aliens, laser) != -1;
+                hits += checkStructures(structures, laser);
+            }
+        }
+
+        benchmarkSink += hits;
+    });
+}
+
+// The player laser pass of update() over one laser per alien: the hits are found over the job system
+// and applied in laser order. Lasers move up and down on alternate ticks so every tick tests the same
+// wave, and the pass is repeated from 1 thread up to one per core.
+static void benchmarkLaserPass(const BenchmarkOptions &options, int entities)
+{
+    WaveLayout layout = getWaveLayout(entities);
+
+    Random random;
+    seedRandom(random, 4, 0);
+
+    AlienStore aliens;
+    createAliens(aliens, layout, entities);
+    destroySome(aliens.isDestroyed, random);
+
+    CollisionGrid grid;
+    setupCollisionGrid(grid, layout.width, layout.height, 64);
+    buildCollisionGrid(grid, aliens);
+
+    LaserStore lasers;
+    reserveLasers(lasers, entities);
+
+    for (const SDL_Rect &bounds : createLaserBounds(entities, layout.width, layout.height, random))
+    {
+        addLaser(lasers, bounds);
+    }
+
+    std::vector<int> hits(entities);
+
+    // powers of two up to the core count, then the core count itself.
+    std::vector<int> threadCounts;
+
+    for (int threads = 1; threads < SDL_GetCPUCount(); threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    }
+
+    threadCounts.push_back(SDL_GetCPUCount());
+
+    for (int threads : threadCounts)
+    {
+        char name[64];
+        SDL_snprintf(name, sizeof(name), "laserPass/threads-%d", threads);
+
+        if (options.filter != nullptr && SDL_strstr(name, options.filter) == nullptr)
+        {
+            continue;
+        }
+
+        startJobSystem(benchmarkJobs, threads);
+
+        runBenchmark(options, name, entities, noSetup, [&](int batch) {
+            int hitCount = 0;
+
+            for (int tick = 0; tick < batch; tick++)
+            {
+                float deltaY = tick % 2 == 0 ? -400 / 120.0f : 400 / 120.0f;
+
+                findLaserAlienHits(benchmarkJobs, grid, aliens, lasers, deltaY, 0, 0, hits.data());
+
+                for (int i = 0; i < entities; i++)
+                {
+                    lasers.y[i] += deltaY;
+                    hitCount += hits[i] != -1;
+                }
+            }
+
+            benchmarkSink += hitCount;
+        });
+
+        stopJobSystem(benchmarkJobs);
+    }
+}
+
+static void benchmarkRemoveDestroyed(const BenchmarkOptions &options, int entities)
+{
+    WaveLayout layout = getWaveLayout(entities);
+
+    Random random;
+    seedRandom(random, 2, 0);
+
+    AlienStore aliens;
+    createAliens(aliens, layout, entities);
+    destroySome(aliens.isDestroyed, random);
+
+    LaserStore lasers;
+    reserveLasers(lasers, entities);
+
+    for (const SDL_Rect &bounds : createLaserBounds(entities, layout.width, layout.height, random))
+    {
+        addLaser(lasers, bounds);
+    }
+
+    destroySome(lasers.isDestroyed, random);
+
+    // compaction is destructive, every operation of the batch gets its own copy made in setup.
+    std::vector<AlienStore> alienCopies;
+    std::vector<LaserStore> laserCopies;
+
+    auto copyAliens = [&](int batch) { alienCopies.assign(batch, aliens); };
+    auto copyLasers = [&](int batch) { laserCopies.assign(batch, lasers); };
+
+    if (entities <= LEGACY_ERASE_LIMIT)
+    {
+        std::vector<LegacyAlien> legacyAliens;
+        createLegacyAliens(legacyAliens, layout, entities);
+
+        for (int i = 0; i < entities; i++)
+        {
+            legacyAliens[i].isDestroyed = aliens.isDestroyed[i];
+        }
+
+        std::vector<std::vector<LegacyAlien>> legacyCopies;
+
+        // the legacy loop erased in place, shifting the tail down once per destroyed alien.
+        runBenchmark(options, "removeDestroyed/aliens-legacy-erase", entities, [&](int batch) { legacyCopies.assign(batch, legacyAliens); }, [&](int batch) {
+            for (int i = 0; i < batch; i++)
+            {
+                std::vector<LegacyAlien> &copy = legacyCopies[i];
+
+                for (auto iterator = copy.begin(); iterator != copy.end();)
+                {
+                    if (iterator->isDestroyed)
+                    {
+                        iterator = copy.erase(iterator);
+                    }
+                    else
+                    {
+                        iterator++;
+                    }
+                }
+            }
+
+            benchmarkSink += (int)legacyCopies[0].size();
+        });
+
+        std::vector<LegacyLaser> legacyLasers;
+
+        for (int i = 0; i < entities; i++)
+        {
+            legacyLasers.push_back({getLaserBounds(lasers, i), lasers.isDestroyed[i] != 0});
+        }
+
+        std::vector<std::vector<LegacyLaser>> legacyLaserCopies;
+
+        runBenchmark(options, "removeDestroyed/lasers-legacy-erase", entities, [&](int batch) { legacyLaserCopies.assign(batch, legacyLasers); }, [&](int batch) {
+            for (int i = 0; i < batch; i++)
+            {
+                std::vector<LegacyLaser> &copy = legacyLaserCopies[i];
+
+                for (auto iterator = copy.begin(); iterator != copy.end();)
+                {
+                    if (iterator->isDestroyed)
+                    {
+                        iterator = copy.erase(iterator);
+                    }
+                    else
+                    {
+                        iterator++;
+                    }
+                }
+            }
+
+            benchmarkSink += (int)legacyLaserCopies[0].size();
+        });
+    }
+
+    runBenchmark(options, "removeDestroyed/aliens-stable", entities, copyAliens, [&](int batch) {
+        for (int i = 0; i < batch; i++)
+        {
+            removeDestroyedAliens(alienCopies[i], COMPACTION_STABLE);
+        }
+
+        benchmarkSink += (int)alienCount(alienCopies[0]);
+    });
+
+    runBenchmark(options, "removeDestroyed/aliens-swap-and-pop", entities, copyAliens, [&](int batch) {
+        for (int i = 0; i < batch; i++)
+        {
+            removeDestroyedAliens(alienCopies[i], COMPACTION_SWAP_AND_POP);
+        }
+
+        benchmarkSink += (int)alienCount(alienCopies[0]);
+    });
+
+    runBenchmark(options, "removeDestroyed/lasers-stable", entities, copyLasers, [&](int batch) {
+        for (int i = 0; i < batch; i++)
+        {
+            removeDestroyedLasers(laserCopies[i], COMPACTION_STABLE);
+        }
+
+        benchmarkSink += (int)laserCount(laserCopies[0]);
+    });
+
+    runBenchmark(options, "removeDestroyed/lasers-swap-and-pop", entities, copyLasers, [&](int batch) {
+        for (int i = 0; i < batch; i++)
+        {
+            removeDestroyedLasers(laserCopies[i], COMPACTION_SWAP_AND_POP);
+        }
+
+        benchmarkSink += (int)laserCount(laserCopies[0]);
+    });
+}
+
+// Stress scene for the sprite batch: every entity is one sprite drawn into a software renderer
+// target, so the numbers do not depend on a GPU or a window.
+static void benchmarkRender(const BenchmarkOptions &options, int entities)
+{
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, 960, 544, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *renderer = target != nullptr ? SDL_CreateSoftwareRenderer(target) : nullptr;
+
+    if (renderer == nullptr)
+    {
+        printf("render benchmarks skipped: %s\n", SDL_GetError());
+        SDL_FreeSurface(target);
+        return;
+    }
+
+    SDL_Surface *spriteSurface = SDL_CreateRGBSurfaceWithFormat(0, 32, 32, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_FillRect(spriteSurface, NULL, SDL_MapRGB(spriteSurface->format, 255, 255, 255));
+
+    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, spriteSurface);
+    SDL_FreeSurface(spriteSurface);
+
+    Random random;
+    seedRandom(random, 3, 0);
+
+    std::vector<Sprite> sprites(entities);
+
+    for (Sprite &sprite : sprites)
+    {
+        sprite.texture = texture;
+        sprite.sourceBounds = {0, 0, 32, 32};
+        sprite.textureBounds = {(int)nextRandomBounded(random, 960 - ALIEN_SIZE), (int)nextRandomBounded(random, 544 - ALIEN_SIZE), ALIEN_SIZE, ALIEN_SIZE};
+    }
+
+    runBenchmark(options, "render/copy-per-sprite", entities, noSetup, [&](int batch) {
+        for (int frame = 0; frame < batch; frame++)
+        {
+            for (const Sprite &sprite : sprites)
+            {
+                SDL_RenderCopy(renderer, sprite.texture, &sprite.sourceBounds, &sprite.textureBounds);
+            }
+        }
+    });
+
+    SpriteBatch spriteBatch = {};
+    beginSpriteBatch(spriteBatch, renderer);
+
+    runBenchmark(options, "render/sprite-batch", entities, noSetup, [&](int batch) {
+        for (int frame = 0; frame < batch; frame++)
+        {
+            beginSpriteBatch(spriteBatch, renderer);
+
+            for (const Sprite &sprite : sprites)
+            {
+                batchSprite(spriteBatch, sprite);
+            }
+
+            flushSpriteBatch(spriteBatch);
+        }
+
+        benchmarkSink += spriteBatch.drawCalls;
+    });
+
+    SDL_DestroyTexture(texture);
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+}
+
+static std::vector<int> parseEntityCounts(const char *list)
+{
+    std::vector<int> counts;
+
+    while (*list != '\0')
+    {
+        int count = SDL_atoi(list);
+
+        if (count > 0)
+        {
+            counts.push_back(count);
+        }
+
+        const char *comma = SDL_strchr(list, ',');
+
+        if (comma == nullptr)
+        {
+            break;
+        }
+
+        list = comma + 1;
+    }
+
+    return counts;
+}
+
+int main(int argc, char *args[])
+{
+    BenchmarkOptions options;
+
+    options.warmup = 3;
+    options.repetitions = 20;
+    options.filter = nullptr;
+    options.entityCounts.assign(DEFAULT_ENTITY_COUNTS, DEFAULT_ENTITY_COUNTS + SDL_arraysize(DEFAULT_ENTITY_COUNTS));
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (SDL_strcmp(args[i], "--warmup") == 0 && i + 1 < argc)
+        {
+            options.warmup = SDL_atoi(args[++i]);
+        }
+        else if (SDL_strcmp(args[i], "--repetitions") == 0 && i + 1 < argc)
+        {
+            options.repetitions = std::max(1, SDL_atoi(args[++i]));
+        }
+        else if (SDL_strcmp(args[i], "--entities") == 0 && i + 1 < argc)
+        {
+            options.entityCounts = parseEntityCounts(args[++i]);
+        }
+        else if (SDL_strcmp(args[i], "--filter") == 0 && i + 1 < argc)
+        {
+            options.filter = args[++i];
+        }
+        else
+        {
+            printf("usage: benchmark [--warmup n] [--repetitions n] [--entities 55,1000,...] [--filter name]\n");
+            return 1;
+        }
+    }
+
+    if (SDL_Init(0) < 0)
+    {
+        printf("SDL could not initialize! SDL_Error: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    printf("%d warmup and %d timed repetitions, times in microseconds per operation\n", options.warmup, options.repetitions);
+    printf("%-36s %8s %6s %11s %11s %11s %10s %11s %10s\n", "benchmark", "entities", "batch", "min", "median", "mean", "stddev", "max", "ns/entity");
+
+    for (int entities : options.entityCounts)
+    {
+        benchmarkCreateAliens(options, entities);
+        benchmarkAliensMovement(options, entities);
+        benchmarkCollisions(options, entities);
+        benchmarkLaserPass(options, entities);
+        benchmarkRemoveDestroyed(options, entities);
+        benchmarkRender(options, entities);
+    }
+
+    SDL_Quit();
+
+    return 0;
+}
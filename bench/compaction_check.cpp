@@ -0,0 +1,218 @@
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <vector>
+#include "entities.h"
+
+// Checks removeDestroyedAliens/removeDestroyedLasers when many entities die in the same frame, built
+// apart from the game with `make check`. Every entity stores its original index in x, so after a
+// compaction the survivors can be compared against the ones that were expected to stay. Exits with
+// 1 when any check failed.
+
+const int STORE_SIZES[] = {1, 2, 7, 64, 1000};
+
+typedef enum
+{
+    KILL_ALL,
+    KILL_NONE,
+    KILL_FIRST,
+    KILL_LAST,
+    KILL_EVEN,
+    KILL_ODD,
+    KILL_PATTERN_COUNT
+} KillPattern;
+
+const char *KILL_PATTERN_NAMES[KILL_PATTERN_COUNT] = {"all", "none", "first", "last", "even", "odd"};
+
+const char *COMPACTION_NAMES[2] = {"stable", "swap-and-pop"};
+
+int failedChecks = 0;
+
+static bool shouldKill(KillPattern pattern, int index, int size)
+{
+    switch (pattern)
+    {
+    case KILL_ALL:
+        return true;
+    case KILL_FIRST:
+        return index == 0;
+    case KILL_LAST:
+        return index == size - 1;
+    case KILL_EVEN:
+        return index % 2 == 0;
+    case KILL_ODD:
+        return index % 2 == 1;
+    default:
+        return false;
+    }
+}
+
+static void fail(const char *store, KillPattern pattern, CompactionMode mode, int size, const char *reason)
+{
+    printf("FAILED %s kill %s %s size %d: %s\n", store, KILL_PATTERN_NAMES[pattern], COMPACTION_NAMES[mode], size, reason);
+    failedChecks++;
+}
+
+// ids are the original indices left in the store, the survivors must be exactly the expected ones,
+// in their original order for the stable mode.
+static bool checkSurvivors(const std::vector<int> &ids, const std::vector<Uint8> &isDestroyed, KillPattern pattern, CompactionMode mode, int size, const char **reason)
+{
+    std::vector<int> expected;
+
+    for (int i = 0; i < size; i++)
+    {
+        if (!shouldKill(pattern, i, size))
+        {
+            expected.push_back(i);
+        }
+    }
+
+    if (ids.size() != expected.size())
+    {
+        *reason = "wrong survivor count";
+        return false;
+    }
+
+    std::vector<int> seen(size, 0);
+
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        if (isDestroyed[i])
+        {
+            *reason = "a destroyed entity survived";
+            return false;
+        }
+
+        if (ids[i] < 0 || ids[i] >= size || shouldKill(pattern, ids[i], size) || seen[ids[i]]++ > 0)
+        {
+            *reason = "wrong survivor set";
+            return false;
+        }
+
+        if (mode == COMPACTION_STABLE && ids[i] != expected[i])
+        {
+            *reason = "survivors out of order";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void checkAliens(KillPattern pattern, CompactionMode mode, int size)
+{
+    AlienStore aliens;
+    reserveAliens(aliens, size);
+
+    for (int i = 0; i < size; i++)
+    {
+        addAlien(aliens, i, 2 * i, 8, 8, i % 5, (Uint8)(i % 3));
+    }
+
+    for (int i = 0; i < size; i++)
+    {
+        aliens.isDestroyed[i] = shouldKill(pattern, i, size);
+    }
+
+    removeDestroyedAliens(aliens, mode);
+
+    const char *reason = nullptr;
+
+    if (!checkSurvivors(aliens.x, aliens.isDestroyed, pattern, mode, size, &reason))
+    {
+        fail("aliens", pattern, mode, size, reason);
+        return;
+    }
+
+    // every other column has to move along with x.
+    for (size_t i = 0; i < alienCount(aliens); i++)
+    {
+        int id = aliens.x[i];
+
+        if (aliens.y[i] != 2 * id || aliens.points[i] != id % 5 || aliens.spriteIndex[i] != id % 3)
+        {
+            fail("aliens", pattern, mode, size, "columns out of step");
+            return;
+        }
+    }
+}
+
+static void checkLasers(KillPattern pattern, CompactionMode mode, int size)
+{
+    LaserStore lasers;
+    reserveLasers(lasers, size);
+
+    std::vector<LaserHandle> handles;
+
+    for (int i = 0; i < size; i++)
+    {
+        handles.push_back(addLaser(lasers, {i, 3 * i, 4, 16}));
+    }
+
+    for (int i = 0; i < size; i++)
+    {
+        lasers.isDestroyed[i] = shouldKill(pattern, i, size);
+    }
+
+    removeDestroyedLasers(lasers, mode);
+
+    const char *reason = nullptr;
+
+    if (!checkSurvivors(lasers.x, lasers.isDestroyed, pattern, mode, size, &reason))
+    {
+        fail("lasers", pattern, mode, size, reason);
+        return;
+    }
+
+    for (size_t i = 0; i < laserCount(lasers); i++)
+    {
+        if (lasers.y[i] != 3 * lasers.x[i])
+        {
+            fail("lasers", pattern, mode, size, "columns out of step");
+            return;
+        }
+    }
+
+    // handles follow the survivors to their new index and stop resolving for the dead ones.
+    for (int i = 0; i < size; i++)
+    {
+        int index = findLaser(lasers, handles[i]);
+
+        if (shouldKill(pattern, i, size) ? index != -1 : (index == -1 || lasers.x[index] != i))
+        {
+            fail("lasers", pattern, mode, size, "stale handle");
+            return;
+        }
+    }
+
+    // the freed slots are reusable right away.
+    for (int i = (int)laserCount(lasers); i < size; i++)
+    {
+        if (findLaser(lasers, addLaser(lasers, {i, 3 * i, 4, 16})) == -1)
+        {
+            fail("lasers", pattern, mode, size, "freed slot not reused");
+            return;
+        }
+    }
+}
+
+int main(int, char *[])
+{
+    int checks = 0;
+
+    for (int size : STORE_SIZES)
+    {
+        for (int pattern = 0; pattern < KILL_PATTERN_COUNT; pattern++)
+        {
+            for (CompactionMode mode : {COMPACTION_STABLE, COMPACTION_SWAP_AND_POP})
+            {
+                checkAliens((KillPattern)pattern, mode, size);
+                checkLasers((KillPattern)pattern, mode, size);
+                checks += 2;
+            }
+        }
+    }
+
+    printf("Compaction check: %d of %d passed\n", checks - failedChecks, checks);
+
+    return failedChecks > 0 ? 1 : 0;
+}
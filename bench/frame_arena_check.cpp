@@ -0,0 +1,128 @@
+#include <SDL2/SDL.h>
+#include <iostream>
+#include "frame_arena.h"
+
+// Checks FrameArena and the arena-backed containers, built apart from the game with `make check`:
+// containers growing inside the arena, requests that fall back to the heap, and the reset that
+// releases both. Exits with 1 when any check failed.
+
+const size_t CHECK_ARENA_SIZE = 4096;
+
+int failedChecks = 0;
+int checks = 0;
+
+static void check(bool isPassing, const char *name)
+{
+    checks++;
+
+    if (!isPassing)
+    {
+        printf("FAILED %s\n", name);
+        failedChecks++;
+    }
+}
+
+static bool isInArena(const FrameArena &arena, const void *memory)
+{
+    const Uint8 *bytes = (const Uint8 *)memory;
+
+    return bytes >= arena.memory && bytes < arena.memory + arena.capacity;
+}
+
+static void checkGrowth(FrameArena &arena)
+{
+    resetFrameArena(arena);
+
+    ArenaVector<int> numbers(arena);
+
+    // growing without a reserve leaves the old buffers behind, but every one of them is in the arena.
+    for (int i = 0; i < 200; i++)
+    {
+        numbers.push_back(i);
+    }
+
+    bool isInOrder = true;
+
+    for (int i = 0; i < 200; i++)
+    {
+        isInOrder = isInOrder && numbers[i] == i;
+    }
+
+    check(isInOrder, "growth keeps the values");
+    check(isInArena(arena, numbers.data()), "growth stays in the arena");
+    check(arena.frameHeapAllocations == 0, "growth needs no heap");
+    check(arena.used >= 200 * sizeof(int), "growth bumps the offset");
+
+    size_t used = arena.used;
+
+    ArenaVector<double> reserved(arena);
+    reserved.reserve(64);
+
+    check(isInArena(arena, reserved.data()), "reserved vector is in the arena");
+    check((uintptr_t)reserved.data() % alignof(double) == 0, "reserved vector is aligned");
+    check(arena.used >= used + 64 * sizeof(double), "reserve takes its capacity at once");
+
+    const char *text = formatArenaText(arena, "score: %d", 1234);
+
+    check(isInArena(arena, text) && SDL_strcmp(text, "score: 1234") == 0, "formatted text is in the arena");
+}
+
+static void checkHeapFallback(FrameArena &arena)
+{
+    resetFrameArena(arena);
+
+    int heapAllocations = arena.heapAllocations;
+
+    void *fitting = allocateFromArena(arena, CHECK_ARENA_SIZE / 2, 16);
+    void *overflow = allocateFromArena(arena, CHECK_ARENA_SIZE, 16);
+
+    check(isInArena(arena, fitting), "fitting request is in the arena");
+    check(overflow != nullptr && !isInArena(arena, overflow), "oversized request falls back to the heap");
+    check((uintptr_t)overflow % 16 == 0, "heap fallback is aligned");
+    check(arena.frameHeapAllocations == 1 && arena.heapAllocations == heapAllocations + 1, "heap fallback is counted");
+
+    // the heap block is usable over its whole size.
+    SDL_memset(overflow, 0xAB, CHECK_ARENA_SIZE);
+
+    ArenaVector<int> big(arena);
+    big.resize(CHECK_ARENA_SIZE);
+
+    check(!isInArena(arena, big.data()) && big[CHECK_ARENA_SIZE - 1] == 0, "oversized container falls back to the heap");
+}
+
+static void checkReset(FrameArena &arena)
+{
+    allocateFromArena(arena, CHECK_ARENA_SIZE * 2, 8);
+
+    int framesWithHeapAllocations = arena.framesWithHeapAllocations;
+
+    resetFrameArena(arena);
+
+    check(arena.used == 0, "reset releases the arena");
+    check(arena.overflowBlocks == nullptr && arena.frameHeapAllocations == 0, "reset frees the heap blocks");
+    check(arena.framesWithHeapAllocations == framesWithHeapAllocations + 1, "reset counts the frame that used the heap");
+    check(arena.highWater > 0, "reset keeps the high water mark");
+
+    void *first = allocateFromArena(arena, 64, 8);
+
+    resetFrameArena(arena);
+
+    check(allocateFromArena(arena, 64, 8) == first, "memory is reused after a reset");
+    check(arena.framesWithHeapAllocations == framesWithHeapAllocations + 1, "frames without heap fallbacks are not counted");
+}
+
+int main(int, char *[])
+{
+    FrameArena arena;
+    createFrameArena(arena, CHECK_ARENA_SIZE);
+
+    checkGrowth(arena);
+    checkHeapFallback(arena);
+    checkReset(arena);
+
+    destroyFrameArena(arena);
+
+    printf("Frame arena check: %d of %d passed\n", checks - failedChecks, checks);
+
+    return failedChecks > 0 ? 1 : 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <iostream>
+#include "profiler.h"
+
+// One bucket per profiler phase plus one for allocations made outside of any phase. Threads that
+// never enter a phase, like the music stream's reader (SDL_AudioStreamPut) and the audio callback,
+// always land in the outside bucket, and it counts towards failing a frame like the others.
+const int ALLOCATION_BUCKETS = PROFILE_PHASE_COUNT + 1;
+
+// frames of a zero allocation test that may still allocate while caches and pools fill up.
+const int DEFAULT_ALLOCATION_WARMUP_FRAMES = 120;
+
+// Counts every operator new and every SDL_malloc/calloc/realloc (SDL and its satellite libraries
+// allocate through SDL's memory functions) once started, attributed to the profiler phase running
+// on the allocating thread. Allocations of every bucket and thread are summed per frame: in the
+// zero allocation test, a frame past the warmup that allocates at all fails the run. Recording
+// inputs only stays allocation free for the ticks reserved by startInputRecording.
+typedef struct
+{
+    bool isEnabled;
+    bool isZeroAllocationTest;
+    int warmupFrames;
+    int frame;
+    // the running counts when the current frame began.
+    Uint64 frameStartCounts[ALLOCATION_BUCKETS];
+    Uint64 frameStartBytes[ALLOCATION_BUCKETS];
+    Uint64 phaseCounts[ALLOCATION_BUCKETS];
+    Uint64 phaseBytes[ALLOCATION_BUCKETS];
+    int allocatingFrames;
+    int failedFrames;
+    Uint64 worstFrameCount;
+    Uint64 worstFrameBytes;
+    int worstFrame;
+} AllocationTracker;
+
+// Call before SDL_Init, SDL's memory functions can only be swapped before SDL allocates anything.
+void startAllocationTracker(AllocationTracker &tracker, bool isZeroAllocationTest, int warmupFrames);
+
+// Closes the previous frame's counts and starts a new frame.
+void beginAllocationFrame(AllocationTracker &tracker);
+
+// Prints allocations per frame and per phase, and the failing frames of a zero allocation test.
+void printAllocationStats(AllocationTracker &tracker);
+
+// 1 once a zero allocation test saw a steady-state frame allocate, the process exit code.
+inline int getAllocationTestStatus(const AllocationTracker &tracker)
+{
+    return tracker.isZeroAllocationTest && tracker.failedFrames > 0 ? 1 : 0;
+}
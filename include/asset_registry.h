@@ -0,0 +1,50 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "sdl_assets_loader.h"
+
+typedef int TextureHandle;
+
+const TextureHandle INVALID_TEXTURE = -1;
+
+typedef struct
+{
+    std::string filePath;
+    SDL_Texture *texture;
+    SDL_Rect sourceBounds;
+    int references;
+    // atlas regions share the registry's atlas texture and stay loaded until the registry is destroyed.
+    bool isAtlasRegion;
+} TextureEntry;
+
+// Loads every texture path once and hands out reference-counted handles to it, a texture is
+// destroyed when its last handle is released. Lookups are a linear scan over the few sprite
+// paths the game uses, which also keeps cache hits free of allocations. Without a renderer
+// (headless runs) only the image sizes are loaded and every texture stays null.
+typedef struct
+{
+    std::vector<TextureEntry> textures;
+    std::vector<TextureHandle> freeHandles;
+    SDL_Texture *atlasTexture;
+    int hits;
+    int misses;
+} AssetRegistry;
+
+// Packs the images into a single atlas texture at load time, after this acquiring any of those paths
+// returns a region of the atlas, so every sprite drawn from it shares one texture binding.
+bool buildSpriteAtlas(AssetRegistry &registry, SDL_Renderer *renderer, const char *const *filePaths, int count);
+
+TextureHandle acquireTexture(AssetRegistry &registry, SDL_Renderer *renderer, const char *filePath);
+
+// Acquires filePath before dropping previousHandle, so a texture used by both is never reloaded.
+TextureHandle reacquireTexture(AssetRegistry &registry, SDL_Renderer *renderer, TextureHandle previousHandle, const char *filePath);
+
+void releaseTexture(AssetRegistry &registry, TextureHandle handle);
+
+Sprite getSprite(const AssetRegistry &registry, TextureHandle handle, int positionX, int positionY);
+
+void destroyAssetRegistry(AssetRegistry &registry);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <atomic>
+
+typedef enum
+{
+    SOUND_LASER,
+    SOUND_EXPLOSION,
+    SOUND_PAUSE,
+    SOUND_COUNT
+} SoundId;
+
+// one queued play request, count is how many requests of the same frame were merged into it.
+typedef struct
+{
+    Uint8 sound;
+    Uint8 count;
+} SoundEvent;
+
+// must be a power of two.
+const int SOUND_QUEUE_CAPACITY = 256;
+
+// Gameplay code never touches SDL_mixer: queueSound only bumps a counter, flushSoundEvents turns
+// the counters of the frame into at most one event per sound and pushes them into a single
+// producer / single consumer ring buffer. An audio thread drains the ring and plays the sounds,
+// so the game thread never waits for the mixer's audio lock.
+// Every sound plays in its own channel group, a full group steals its oldest voice.
+typedef struct
+{
+    Mix_Chunk *chunks[SOUND_COUNT];
+    int volumes[SOUND_COUNT];
+    // game thread only.
+    int pendingCounts[SOUND_COUNT];
+    int queuedEvents;
+    int mergedEvents;
+    int droppedEvents;
+    SoundEvent events[SOUND_QUEUE_CAPACITY];
+    // head is only written by the game thread, tail only by the audio thread.
+    std::atomic<Uint32> head;
+    std::atomic<Uint32> tail;
+    std::atomic<bool> isRunning;
+    SDL_Thread *thread;
+} AudioQueue;
+
+// volume is the channel volume of a single play, merged plays get louder from there.
+void setQueuedSound(AudioQueue &queue, SoundId sound, Mix_Chunk *chunk, int volume);
+
+// Groups the mixer channels and starts the audio thread, call after Mix_OpenAudio.
+bool startAudioQueue(AudioQueue &queue);
+
+void queueSound(AudioQueue &queue, SoundId sound);
+
+// Once per frame. Without a running audio thread (headless) the pending sounds are dropped.
+void flushSoundEvents(AudioQueue &queue);
+
+// Stops the audio thread and prints the queue statistics, call before freeing the chunks.
+void stopAudioQueue(AudioQueue &queue);
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "entities.h"
+#include "job_system.h"
+
+// Uniform grid broadphase over the alien slots. Each cell stores the indices of the aliens that
+// overlap it in one flat array (cellStarts[cell] .. cellStarts[cell + 1]), so a rebuild is two
+// linear passes and never allocates once the vectors have grown to the wave size.
+// Slots are formation-relative, so the grid only needs building once per wave and queries
+// take bounds in formation space.
+typedef struct
+{
+    int cellSize;
+    int columns;
+    int rows;
+    std::vector<int> cellStarts;
+    std::vector<int> cellCursors;
+    std::vector<int> cellItems;
+} CollisionGrid;
+
+void setupCollisionGrid(CollisionGrid &grid, int width, int height, int cellSize);
+
+void buildCollisionGrid(CollisionGrid &grid, const AlienStore &aliens);
+
+// Returns the lowest index of a live alien intersecting bounds, or -1, the same alien the
+// brute force scan over every alien would have found.
+int findAlienCollision(const CollisionGrid &grid, const AlienStore &aliens, const SDL_Rect &bounds);
+
+// findAlienCollision for every laser of the store as if moved vertically by deltaY, split over the
+// job system. hits[i] gets the alien the i-th laser hits, or -1, against the destroyed flags as they
+// are when called: the aliens and lasers are only read, so the caller applies the hits in laser order.
+void findLaserAlienHits(JobSystem &jobs, const CollisionGrid &grid, const AlienStore &aliens, const LaserStore &lasers, float deltaY, int offsetX, int offsetY, int *hits);
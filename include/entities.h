@@ -0,0 +1,163 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+// Aliens and lasers are stored as structure-of-arrays: every field lives in its own
+// contiguous column, so movement, collision and render loops only pull the data they use.
+// Alien x/y are fixed slots relative to the Formation, dead aliens keep their slot.
+typedef struct
+{
+    std::vector<int> x;
+    std::vector<int> y;
+    std::vector<int> w;
+    std::vector<int> h;
+    std::vector<int> points;
+    // index into the shared alien sprite table instead of a per-alien texture copy.
+    std::vector<Uint8> spriteIndex;
+    std::vector<Uint8> isDestroyed;
+} AlienStore;
+
+// A laser outside its store is referred to by a handle: the slot stays the same while compaction
+// moves the laser around the columns, and the generation no longer matches once the laser is gone.
+typedef struct
+{
+    Uint32 slot;
+    Uint32 generation;
+} LaserHandle;
+
+const LaserHandle INVALID_LASER = {0, 0};
+
+// y is kept in float so fixed simulation steps never lose sub-pixel movement to truncation,
+// previousY is the position at the start of the current tick, used to interpolate rendering.
+// The store is a fixed-capacity pool set up by reserveLasers: the columns stay dense for the
+// update loops, slotIndex maps every slot to its laser's current column index and freed slots
+// go back to a free list, so firing and removing lasers never allocates.
+typedef struct
+{
+    std::vector<int> x;
+    std::vector<float> y;
+    std::vector<float> previousY;
+    std::vector<int> w;
+    std::vector<int> h;
+    std::vector<Uint8> isDestroyed;
+    // the slot of every laser in the columns.
+    std::vector<Uint32> slot;
+    std::vector<Uint32> slotIndex;
+    // odd while the slot holds a laser, bumped every time it is taken or freed.
+    std::vector<Uint32> slotGeneration;
+    std::vector<Uint32> freeSlots;
+    // shots fired while every slot was taken.
+    int droppedLasers;
+} LaserStore;
+
+// The whole alien grid moves rigidly, so movement only updates this shared offset. Slots are laid
+// out row by row with `columns` slots per row, ordered left to right, and the alive count of every
+// column gives the leftmost/rightmost live column for the edge check without touching the aliens.
+typedef struct
+{
+    float x;
+    int y;
+    float previousX;
+    int previousY;
+    int velocity;
+    int columns;
+    int aliveCount;
+    int leftmostColumn;
+    int rightmostColumn;
+    std::vector<int> columnAliveCount;
+    // local horizontal extent of the live aliens of each column.
+    std::vector<int> columnLeft;
+    std::vector<int> columnRight;
+} Formation;
+
+// How removeDestroyed* closes the gaps left by destroyed entities, both run in one linear sweep:
+// stable keeps the survivors in their original order, swap-and-pop moves the last element into
+// each hole and is cheaper when many entities die together but does not preserve order.
+typedef enum
+{
+    COMPACTION_STABLE,
+    COMPACTION_SWAP_AND_POP
+} CompactionMode;
+
+void reserveAliens(AlienStore &aliens, size_t capacity);
+
+void addAlien(AlienStore &aliens, int x, int y, int w, int h, int points, Uint8 spriteIndex);
+
+void removeDestroyedAliens(AlienStore &aliens, CompactionMode mode);
+
+// Returns the index of the liveIndex-th alien still alive, or -1.
+int findLiveAlien(const AlienStore &aliens, int liveIndex);
+
+void clearAliens(AlienStore &aliens);
+
+void setupFormation(Formation &formation, const AlienStore &aliens, int columns, int velocity);
+
+void destroyAlien(Formation &formation, AlienStore &aliens, int index);
+
+void moveFormation(Formation &formation, float deltaTime, int screenWidth);
+
+// Allocates the pool, only call it while the store holds no lasers.
+void reserveLasers(LaserStore &lasers, size_t capacity);
+
+// Returns INVALID_LASER and drops the shot when the pool is full.
+LaserHandle addLaser(LaserStore &lasers, const SDL_Rect &bounds);
+
+void removeDestroyedLasers(LaserStore &lasers, CompactionMode mode);
+
+void clearLasers(LaserStore &lasers);
+
+inline size_t alienCount(const AlienStore &aliens)
+{
+    return aliens.isDestroyed.size();
+}
+
+inline size_t laserCount(const LaserStore &lasers)
+{
+    return lasers.isDestroyed.size();
+}
+
+inline LaserHandle getLaserHandle(const LaserStore &lasers, size_t index)
+{
+    Uint32 slot = lasers.slot[index];
+
+    return {slot, lasers.slotGeneration[slot]};
+}
+
+// Returns the laser's current index in the columns, or -1 once it was removed.
+inline int findLaser(const LaserStore &lasers, LaserHandle handle)
+{
+    if (handle.slot >= lasers.slotGeneration.size() || lasers.slotGeneration[handle.slot] != handle.generation || (handle.generation & 1) == 0)
+    {
+        return -1;
+    }
+
+    return (int)lasers.slotIndex[handle.slot];
+}
+
+// floored so local and screen space always differ by the same whole number of pixels.
+inline int getFormationOffsetX(const Formation &formation)
+{
+    return (int)SDL_floorf(formation.x);
+}
+
+inline SDL_Rect getAlienBounds(const AlienStore &aliens, const Formation &formation, size_t index)
+{
+    return {getFormationOffsetX(formation) + aliens.x[index], formation.y + aliens.y[index], aliens.w[index], aliens.h[index]};
+}
+
+inline SDL_Rect getLaserBounds(const LaserStore &lasers, size_t index)
+{
+    return {lasers.x[index], (int)lasers.y[index], lasers.w[index], lasers.h[index]};
+}
+
+// Same result as SDL_HasIntersection, but inlined so the hot loops can test straight from the columns.
+inline bool hasIntersection(int x, int y, int w, int h, const SDL_Rect &bounds)
+{
+    if (w <= 0 || h <= 0 || bounds.w <= 0 || bounds.h <= 0)
+    {
+        return false;
+    }
+
+    return x < bounds.x + bounds.w && bounds.x < x + w && y < bounds.y + bounds.h && bounds.y < y + h;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <vector>
+
+// Scratch memory that only lives until the end of the frame: allocating bumps an offset into one
+// block reserved at startup and resetFrameArena at the top of the frame releases everything at
+// once. Requests that do not fit fall back to the heap and are freed on the next reset. The heap
+// counters only cover the arena's own fallbacks, not the rest of the frame: the allocation tracker
+// (--track-allocations, --zero-alloc-test) counts every heap allocation, and since the fallbacks go
+// through SDL_malloc it counts those too.
+typedef struct
+{
+    Uint8 *memory;
+    size_t capacity;
+    size_t used;
+    size_t highWater;
+    // heap blocks of the current frame, linked through their first bytes.
+    void *overflowBlocks;
+    int frameHeapAllocations;
+    int heapAllocations;
+    int framesWithHeapAllocations;
+} FrameArena;
+
+const size_t DEFAULT_FRAME_ARENA_SIZE = 256 * 1024;
+
+void createFrameArena(FrameArena &arena, size_t capacity);
+
+void destroyFrameArena(FrameArena &arena);
+
+void resetFrameArena(FrameArena &arena);
+
+void *allocateFromArena(FrameArena &arena, size_t size, size_t alignment);
+
+// printf into the arena, the text stays valid until the next reset.
+const char *formatArenaText(FrameArena &arena, const char *format, ...);
+
+void printFrameArenaStats(const FrameArena &arena, const char *name);
+
+// Lets standard containers live in the arena. Freeing is a no-op, the memory comes back with
+// the reset, so reserve containers that grow to avoid leaving their old buffers behind.
+template <typename T>
+struct ArenaAllocator
+{
+    typedef T value_type;
+
+    FrameArena *arena;
+
+    ArenaAllocator(FrameArena &arena) : arena(&arena)
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena)
+    {
+    }
+
+    T *allocate(size_t count)
+    {
+        return (T *)allocateFromArena(*arena, count * sizeof(T), alignof(T));
+    }
+
+    void deallocate(T *, size_t)
+    {
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &first, const ArenaAllocator<U> &second)
+{
+    return first.arena == second.arena;
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &first, const ArenaAllocator<U> &second)
+{
+    return first.arena != second.arena;
+}
+
+// e.g. ArenaVector<int> hits(simulationArena); must not outlive the frame it was created in.
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
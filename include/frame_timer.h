@@ -0,0 +1,42 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <iostream>
+
+// number of most recent frames the statistics are computed over.
+const int FRAME_TIMER_WINDOW = 1024;
+
+// Frame timing on SDL's high resolution performance counter, every frame time is kept in a
+// ring buffer so the pacing of the last FRAME_TIMER_WINDOW frames can be analysed.
+typedef struct
+{
+    Uint64 frequency;
+    Uint64 previousCounter;
+    float frameTimes[FRAME_TIMER_WINDOW];
+    int nextSample;
+    int sampleCount;
+} FrameTimer;
+
+typedef struct
+{
+    float min;
+    float average;
+    float p50;
+    float p90;
+    float p99;
+    float max;
+    int samples;
+} FrameStats;
+
+void startFrameTimer(FrameTimer &timer);
+
+// Returns the seconds elapsed since the previous call and records them in the window.
+float tickFrameTimer(FrameTimer &timer);
+
+FrameStats getFrameStats(const FrameTimer &timer);
+
+// Same statistics over any list of frame times in seconds, e.g. every tick of a whole run.
+FrameStats computeFrameStats(const float *frameTimes, int count);
+
+// Prints min/avg/p99/max and a 1 ms bucket histogram of the window.
+void printFrameStats(const FrameTimer &timer);
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <iostream>
+
+const int FIRST_ATLAS_GLYPH = 32;
+const int LAST_ATLAS_GLYPH = 126;
+const int ATLAS_GLYPH_COUNT = LAST_ATLAS_GLYPH - FIRST_ATLAS_GLYPH + 1;
+
+// Every printable ASCII glyph of a font rasterized once into a single texture, text is then
+// drawn by copying glyph rects out of it, so changing strings never touches TTF or the GPU.
+typedef struct
+{
+    SDL_Texture *texture;
+    SDL_Rect glyphBounds[ATLAS_GLYPH_COUNT];
+    int advances[ATLAS_GLYPH_COUNT];
+    int lineHeight;
+} GlyphAtlas;
+
+GlyphAtlas loadGlyphAtlas(SDL_Renderer *renderer, TTF_Font *font);
+
+// Characters outside the atlas are skipped, returns the width of the drawn text.
+int renderText(SDL_Renderer *renderer, const GlyphAtlas &atlas, const char *text, int positionX, int positionY);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <iostream>
+#include <vector>
+
+// The per-tick input bitmasks of a run plus the seed the simulation was started with. Since the
+// simulation runs on a fixed timestep, replaying the same inputs from the same seed reproduces
+// the run tick by tick. Files store the inputs run-length encoded, so a held key costs a few bytes.
+typedef struct
+{
+    Uint32 seed;
+    std::vector<Uint8> inputs;
+} InputRecording;
+
+// an hour of play at 120 ticks per second, reserved up front so recording does not allocate.
+const size_t DEFAULT_RECORDING_TICKS = 120 * 60 * 60;
+
+// Clears the recording and reserves room for expectedTicks inputs, runs longer than that regrow the
+// buffer now and then, which a --zero-alloc-test run reports.
+void startInputRecording(InputRecording &recording, Uint32 seed, size_t expectedTicks);
+
+void recordInput(InputRecording &recording, Uint8 input);
+
+bool saveInputRecording(const InputRecording &recording, const char *filePath);
+
+bool loadInputRecording(InputRecording &recording, const char *filePath);
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <iostream>
+
+const int MAX_JOB_THREADS = 64;
+const int JOB_QUEUE_CAPACITY = 256;
+
+typedef void (*JobFunction)(void *data, int begin, int end);
+
+// one batch of a parallel for: function runs over [begin, end).
+typedef struct
+{
+    JobFunction function;
+    void *data;
+    int begin;
+    int end;
+    // batches of the parallel for not finished yet.
+    SDL_atomic_t *pending;
+} Job;
+
+// A ring of jobs behind a spin lock: the owner pushes and pops at the bottom, idle threads steal
+// from the top, so thieves take the batches the owner would get to last.
+typedef struct
+{
+    SDL_SpinLock lock;
+    int top;
+    int bottom;
+    Job jobs[JOB_QUEUE_CAPACITY];
+} JobQueue;
+
+// Work-stealing scheduler for data parallel loops. Queue 0 belongs to the thread that calls
+// parallelFor (the simulation thread in the game), queues 1 to threadCount - 1 to the workers.
+// The caller works through its own batches while the workers steal from it, and it steals back
+// while waiting for the last ones, so a parallel for never sleeps. Idle workers block on a
+// semaphore. Only one thread at a time may submit from outside the workers.
+typedef struct
+{
+    int threadCount;
+    JobQueue queues[MAX_JOB_THREADS];
+    SDL_Thread *threads[MAX_JOB_THREADS];
+    SDL_sem *wakeSignal;
+    // workers take their queue index from this when they start.
+    SDL_atomic_t startedWorkers;
+    SDL_atomic_t isStopping;
+} JobSystem;
+
+// threadCount counts the calling thread, 1 runs every parallel for inline. Allocate the system
+// statically or on the heap, the queues are too big for the stack.
+bool startJobSystem(JobSystem &jobs, int threadCount);
+
+// Splits [0, count) into batches of at least minBatchSize items and returns once all ran. Ranges
+// below two batches run inline, so small waves pay nothing for the threads.
+void parallelFor(JobSystem &jobs, int count, int minBatchSize, JobFunction function, void *data);
+
+void stopJobSystem(JobSystem &jobs);
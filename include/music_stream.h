@@ -0,0 +1,50 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+const int DEFAULT_MUSIC_BUFFER_MILLISECONDS = 500;
+
+// Streams a WAV track from disk instead of holding it in memory: a reader thread reads the PCM in
+// chunks into a single producer / single consumer ring buffer, and the mixer's music hook mixes it
+// out of the ring. A track already in the mixer's output format is read straight into the ring,
+// anything else goes through an SDL_AudioStream. The ring holds bufferMilliseconds of audio, a
+// smaller ring uses less memory but is more likely to run dry when the reader falls behind.
+typedef struct
+{
+    SDL_RWops *file;
+    // the PCM samples of the WAV file.
+    Sint64 dataStart;
+    Sint64 dataSize;
+    Sint64 dataPosition;
+    // null when the track is already in the output format.
+    SDL_AudioStream *converter;
+    std::vector<Uint8> readBuffer;
+    std::vector<Uint8> ring;
+    Uint32 ringMask;
+    // head is only written by the reader thread, tail only by the mixer.
+    std::atomic<Uint32> head;
+    std::atomic<Uint32> tail;
+    std::atomic<bool> isRunning;
+    std::atomic<bool> isFinished;
+    SDL_Thread *thread;
+    Uint16 outputFormat;
+    Uint32 frameSize;
+    int bytesPerSecond;
+    int volume;
+    bool isLooping;
+    // mixer side: callbacks that found less audio than they asked for and the emptiest the ring got.
+    int underruns;
+    Uint32 lowestFill;
+} MusicStream;
+
+bool openMusicStream(MusicStream &stream, const char *filePath, int bufferMilliseconds, bool isLooping);
+
+// Starts the reader and hooks the stream into the mixer, volume goes from 0 to MIX_MAX_VOLUME.
+void playMusicStream(MusicStream &stream, int volume);
+
+// Unhooks and closes the stream and prints the buffer statistics.
+void closeMusicStream(MusicStream &stream);
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <iostream>
+#include "glyph_atlas.h"
+
+typedef enum
+{
+    PROFILE_HANDLE_EVENTS,
+    PROFILE_UPDATE,
+    PROFILE_ALIENS_MOVEMENT,
+    PROFILE_REMOVE_DESTROYED,
+    PROFILE_RENDER,
+    PROFILE_PHASE_COUNT
+} ProfilePhase;
+
+extern const char *PROFILE_PHASE_NAMES[PROFILE_PHASE_COUNT];
+
+// the innermost phase running on this thread, -1 outside of any, kept even while the profiler is
+// disabled so the allocation tracker can attribute allocations to phases.
+extern thread_local int currentProfilePhase;
+
+// frames kept for the overlay and individual timings kept for the trace export.
+const int PROFILER_FRAMES = 128;
+const int PROFILER_EVENTS = 16384;
+
+typedef struct
+{
+    Uint8 phase;
+    // 1 for the main thread, 2 for any other, the trace shows them as separate tracks.
+    Uint8 thread;
+    Uint64 start;
+    Uint64 duration;
+} ProfileEvent;
+
+// Per-phase timings in ring buffers, every timed scope adds one event and its duration to the
+// total of the current frame. While disabled a scope costs a single branch. Scopes may run on the
+// simulation thread and the main thread at once, as long as each phase is only timed on one of them.
+typedef struct
+{
+    bool isEnabled;
+    Uint64 frequency;
+    Uint64 startCounter;
+    SDL_threadID mainThread;
+    int frame;
+    Uint64 frameTimes[PROFILER_FRAMES][PROFILE_PHASE_COUNT];
+    ProfileEvent events[PROFILER_EVENTS];
+    // events ever added, each thread claims its slot in the ring with one atomic add.
+    SDL_atomic_t writtenEvents;
+} Profiler;
+
+void startProfiler(Profiler &profiler, bool isEnabled);
+
+void beginProfilerFrame(Profiler &profiler);
+
+void addProfileEvent(Profiler &profiler, ProfilePhase phase, Uint64 start, Uint64 end);
+
+// Draws the average and worst time of every phase over the last PROFILER_FRAMES frames, and below
+// them one stacked bar of the phase times per frame against the 60 fps budget.
+void renderProfilerOverlay(SDL_Renderer *renderer, const Profiler &profiler, const GlyphAtlas &atlas);
+
+// Writes the buffered events in the Chrome trace event format, open it in chrome://tracing or Perfetto.
+bool exportChromeTrace(const Profiler &profiler, const char *filePath);
+
+// Times the enclosing scope as one event of the given phase.
+struct ProfileScope
+{
+    Profiler &profiler;
+    ProfilePhase phase;
+    int previousPhase;
+    Uint64 start;
+
+    ProfileScope(Profiler &profiler, ProfilePhase phase) : profiler(profiler), phase(phase), previousPhase(currentProfilePhase), start(0)
+    {
+        currentProfilePhase = phase;
+
+        if (profiler.isEnabled)
+        {
+            start = SDL_GetPerformanceCounter();
+        }
+    }
+
+    ~ProfileScope()
+    {
+        if (profiler.isEnabled && start != 0)
+        {
+            addProfileEvent(profiler, phase, start, SDL_GetPerformanceCounter());
+        }
+
+        currentProfilePhase = previousPhase;
+    }
+};
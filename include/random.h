@@ -0,0 +1,59 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+// Small seedable PCG32 generator (O'Neill, pcg-random.org). Every subsystem owns its own state,
+// so drawing numbers in one never shifts the sequence of another, and the output is the same
+// on every platform, unlike rand().
+typedef struct
+{
+    Uint64 state;
+    Uint64 increment;
+} Random;
+
+// one stream per subsystem, so they stay independent even when seeded with the same value.
+enum
+{
+    RANDOM_STREAM_ALIEN_FIRE = 1
+};
+
+inline Uint32 nextRandom(Random &random)
+{
+    Uint64 previousState = random.state;
+    random.state = previousState * 6364136223846793005ULL + random.increment;
+
+    Uint32 xorShifted = (Uint32)(((previousState >> 18) ^ previousState) >> 27);
+    Uint32 rotation = (Uint32)(previousState >> 59);
+
+    return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+}
+
+inline void seedRandom(Random &random, Uint64 seed, Uint64 stream)
+{
+    random.state = 0;
+    random.increment = (stream << 1) | 1;
+
+    nextRandom(random);
+    random.state += seed;
+    nextRandom(random);
+}
+
+// Uniform value in [0, bound) without the modulo bias of `% bound` (Lemire's multiply and reject).
+inline Uint32 nextRandomBounded(Random &random, Uint32 bound)
+{
+    Uint64 product = (Uint64)nextRandom(random) * bound;
+    Uint32 low = (Uint32)product;
+
+    if (low < bound)
+    {
+        Uint32 threshold = (0u - bound) % bound;
+
+        while (low < threshold)
+        {
+            product = (Uint64)nextRandom(random) * bound;
+            low = (Uint32)product;
+        }
+    }
+
+    return (Uint32)(product >> 32);
+}
@@ -10,6 +10,8 @@ typedef struct
 {
     SDL_Texture *texture;
     SDL_Rect textureBounds;
+    // region of the texture to draw, sprites packed in an atlas share one texture.
+    SDL_Rect sourceBounds;
 } Sprite;
 
 Sprite loadSprite(SDL_Renderer *renderer, const char *filePath, int positionX, int positionY);
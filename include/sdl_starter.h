@@ -9,4 +9,13 @@
 const int SCREEN_WIDTH = 960;
 const int SCREEN_HEIGHT = 544;
 
-int startSDL(SDL_Window *window, SDL_Renderer *renderer);
\ No newline at end of file
+// the mixer's output format, the sound bank is baked in it so its PCM plays without conversion.
+const int AUDIO_FREQUENCY = 44100;
+const Uint16 AUDIO_FORMAT = MIX_DEFAULT_FORMAT;
+const int AUDIO_CHANNELS = 2;
+// samples per mixer callback, smaller means less latency and more risk of crackling.
+const int DEFAULT_AUDIO_BUFFER_SAMPLES = 2048;
+
+int startSDL(SDL_Window *window, SDL_Renderer *renderer, int audioBufferSamples);
+
+int startHeadlessSDL();
\ No newline at end of file
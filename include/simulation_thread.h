@@ -0,0 +1,29 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <iostream>
+
+// A dedicated thread running one job per frame: kickSimulationThread hands the job over and returns
+// right away, waitForSimulationThread blocks until it is done. The semaphores order the memory
+// accesses, everything the main thread wrote before the kick is visible to the job, and everything
+// the job wrote is visible once the wait returns.
+typedef struct
+{
+    SDL_Thread *thread;
+    SDL_sem *startSignal;
+    SDL_sem *doneSignal;
+    void (*job)(void *data);
+    void *data;
+    bool isStopping;
+    bool isBusy;
+} SimulationThread;
+
+// When the thread cannot be started, kicks run the job on the calling thread instead.
+bool startSimulationThread(SimulationThread &simulation, void (*job)(void *data), void *data);
+
+void kickSimulationThread(SimulationThread &simulation);
+
+void waitForSimulationThread(SimulationThread &simulation);
+
+// Waits for a running job to finish before joining the thread.
+void stopSimulationThread(SimulationThread &simulation);
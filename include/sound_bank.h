@@ -0,0 +1,35 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <iostream>
+
+// A single file holding the game's sounds as PCM already in the mixer's output format, so loading
+// does no decoding or resampling: the file is memory-mapped and each sound is handed to the mixer
+// with Mix_QuickLoad_RAW pointing straight into the mapping. The pages are read-only and backed by
+// the file, the OS can drop them under memory pressure instead of them counting as heap.
+typedef struct
+{
+    Uint8 *data;
+    size_t size;
+    int frequency;
+    Uint16 format;
+    int channels;
+    int soundCount;
+#ifdef _WIN32
+    // the file and mapping HANDLEs, kept opaque so windows.h stays out of this header.
+    void *file;
+    void *mapping;
+#endif
+} SoundBank;
+
+// Decodes the WAV files and converts them to the given format, sounds keep the order of filePaths.
+bool bakeSoundBank(const char *const *filePaths, int count, const char *bankPath, int frequency, Uint16 format, int channels);
+
+// Maps the bank, fails when it is missing, damaged or baked for another format than the open mixer's.
+bool openSoundBank(SoundBank &bank, const char *bankPath);
+
+// The chunk references the mapping: free it with Mix_FreeChunk before closing the bank.
+Mix_Chunk *loadBankSound(const SoundBank &bank, int index);
+
+void closeSoundBank(SoundBank &bank);
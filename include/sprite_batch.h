@@ -0,0 +1,31 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <vector>
+#include "sdl_assets_loader.h"
+
+// Collects textured and solid quads into a reusable vertex buffer and submits each run of quads
+// sharing a texture with one SDL_RenderGeometry call. The buffers keep their capacity between
+// frames, so steady-state batching does not allocate.
+typedef struct
+{
+    SDL_Renderer *renderer;
+    SDL_Texture *texture;
+    float inverseTextureWidth;
+    float inverseTextureHeight;
+    std::vector<SDL_Vertex> vertices;
+    // the index pattern of a quad never changes, so it is only extended when the batch grows.
+    std::vector<int> indices;
+    int drawCalls;
+} SpriteBatch;
+
+void beginSpriteBatch(SpriteBatch &batch, SDL_Renderer *renderer);
+
+// Switching texture flushes the quads queued so far, group draws by texture to keep calls down.
+void batchSprite(SpriteBatch &batch, SDL_Texture *texture, const SDL_Rect &sourceBounds, const SDL_Rect &bounds);
+
+void batchSprite(SpriteBatch &batch, const Sprite &sprite);
+
+void batchRect(SpriteBatch &batch, const SDL_Rect &bounds, SDL_Color color);
+
+void flushSpriteBatch(SpriteBatch &batch);
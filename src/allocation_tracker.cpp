@@ -0,0 +1,257 @@
+#include "allocation_tracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// only the first failing frames of a zero allocation test are printed one by one.
+const int PRINTED_FAILED_FRAMES = 10;
+
+static std::atomic<bool> isTracking(false);
+static std::atomic<Uint64> allocationCounts[ALLOCATION_BUCKETS];
+static std::atomic<Uint64> allocationBytes[ALLOCATION_BUCKETS];
+
+static SDL_malloc_func sdlMalloc;
+static SDL_calloc_func sdlCalloc;
+static SDL_realloc_func sdlRealloc;
+static SDL_free_func sdlFree;
+
+static void countAllocation(size_t size)
+{
+    if (!isTracking.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    int bucket = currentProfilePhase + 1;
+
+    allocationCounts[bucket].fetch_add(1, std::memory_order_relaxed);
+    allocationBytes[bucket].fetch_add(size, std::memory_order_relaxed);
+}
+
+static void *SDLCALL trackedMalloc(size_t size)
+{
+    countAllocation(size);
+    return sdlMalloc(size);
+}
+
+static void *SDLCALL trackedCalloc(size_t count, size_t size)
+{
+    countAllocation(count * size);
+    return sdlCalloc(count, size);
+}
+
+static void *SDLCALL trackedRealloc(void *memory, size_t size)
+{
+    countAllocation(size);
+    return sdlRealloc(memory, size);
+}
+
+static void SDLCALL trackedFree(void *memory)
+{
+    sdlFree(memory);
+}
+
+static void *allocate(size_t size)
+{
+    countAllocation(size);
+
+    void *memory = std::malloc(size > 0 ? size : 1);
+
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return memory;
+}
+
+void *operator new(size_t size)
+{
+    return allocate(size);
+}
+
+void *operator new[](size_t size)
+{
+    return allocate(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    countAllocation(size);
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    countAllocation(size);
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t &) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t &) noexcept
+{
+    std::free(memory);
+}
+
+static const char *getBucketName(int bucket)
+{
+    return bucket == 0 ? "outside phases" : PROFILE_PHASE_NAMES[bucket - 1];
+}
+
+void startAllocationTracker(AllocationTracker &tracker, bool isZeroAllocationTest, int warmupFrames)
+{
+    tracker.isEnabled = true;
+    tracker.isZeroAllocationTest = isZeroAllocationTest;
+    tracker.warmupFrames = warmupFrames;
+    tracker.frame = 0;
+    tracker.allocatingFrames = 0;
+    tracker.failedFrames = 0;
+    tracker.worstFrameCount = 0;
+    tracker.worstFrameBytes = 0;
+    tracker.worstFrame = 0;
+
+    for (int bucket = 0; bucket < ALLOCATION_BUCKETS; bucket++)
+    {
+        tracker.phaseCounts[bucket] = 0;
+        tracker.phaseBytes[bucket] = 0;
+    }
+
+    SDL_GetMemoryFunctions(&sdlMalloc, &sdlCalloc, &sdlRealloc, &sdlFree);
+
+    if (SDL_SetMemoryFunctions(trackedMalloc, trackedCalloc, trackedRealloc, trackedFree) < 0)
+    {
+        printf("SDL allocations are not tracked: %s\n", SDL_GetError());
+    }
+
+    isTracking.store(true);
+}
+
+static void endAllocationFrame(AllocationTracker &tracker)
+{
+    Uint64 frameCount = 0;
+    Uint64 frameBytes = 0;
+    Uint64 bucketCounts[ALLOCATION_BUCKETS];
+
+    for (int bucket = 0; bucket < ALLOCATION_BUCKETS; bucket++)
+    {
+        bucketCounts[bucket] = allocationCounts[bucket].load(std::memory_order_relaxed) - tracker.frameStartCounts[bucket];
+        Uint64 bytes = allocationBytes[bucket].load(std::memory_order_relaxed) - tracker.frameStartBytes[bucket];
+
+        tracker.phaseCounts[bucket] += bucketCounts[bucket];
+        tracker.phaseBytes[bucket] += bytes;
+
+        frameCount += bucketCounts[bucket];
+        frameBytes += bytes;
+    }
+
+    if (frameCount == 0)
+    {
+        return;
+    }
+
+    tracker.allocatingFrames++;
+
+    if (frameCount > tracker.worstFrameCount)
+    {
+        tracker.worstFrameCount = frameCount;
+        tracker.worstFrameBytes = frameBytes;
+        tracker.worstFrame = tracker.frame;
+    }
+
+    if (!tracker.isZeroAllocationTest || tracker.frame <= tracker.warmupFrames)
+    {
+        return;
+    }
+
+    tracker.failedFrames++;
+
+    if (tracker.failedFrames > PRINTED_FAILED_FRAMES)
+    {
+        return;
+    }
+
+    printf("Frame %d allocated %d times, %d bytes:", tracker.frame, (int)frameCount, (int)frameBytes);
+
+    for (int bucket = 0; bucket < ALLOCATION_BUCKETS; bucket++)
+    {
+        if (bucketCounts[bucket] > 0)
+        {
+            printf(" %s %d", getBucketName(bucket), (int)bucketCounts[bucket]);
+        }
+    }
+
+    printf("\n");
+}
+
+void beginAllocationFrame(AllocationTracker &tracker)
+{
+    if (!tracker.isEnabled)
+    {
+        return;
+    }
+
+    if (tracker.frame > 0)
+    {
+        endAllocationFrame(tracker);
+    }
+
+    tracker.frame++;
+
+    for (int bucket = 0; bucket < ALLOCATION_BUCKETS; bucket++)
+    {
+        tracker.frameStartCounts[bucket] = allocationCounts[bucket].load(std::memory_order_relaxed);
+        tracker.frameStartBytes[bucket] = allocationBytes[bucket].load(std::memory_order_relaxed);
+    }
+}
+
+void printAllocationStats(AllocationTracker &tracker)
+{
+    if (!tracker.isEnabled)
+    {
+        return;
+    }
+
+    // the frame in progress is cut short by the quit, only the completed ones count.
+    int frames = tracker.frame > 0 ? tracker.frame - 1 : 0;
+
+    printf("Allocations: %d of %d frames allocated, worst frame %d with %d allocations, %d bytes\n", tracker.allocatingFrames, frames, tracker.worstFrame, (int)tracker.worstFrameCount, (int)tracker.worstFrameBytes);
+
+    for (int bucket = 0; bucket < ALLOCATION_BUCKETS; bucket++)
+    {
+        if (tracker.phaseCounts[bucket] > 0)
+        {
+            printf("  %s: %.2f allocations, %.0f bytes per frame\n", getBucketName(bucket), (double)tracker.phaseCounts[bucket] / SDL_max(frames, 1), (double)tracker.phaseBytes[bucket] / SDL_max(frames, 1));
+        }
+    }
+
+    if (tracker.isZeroAllocationTest)
+    {
+        int steadyFrames = SDL_max(frames - tracker.warmupFrames, 0);
+
+        printf("Zero allocation test %s: %d of %d frames after the %d frame warmup allocated\n", tracker.failedFrames == 0 ? "passed" : "FAILED", tracker.failedFrames, steadyFrames, tracker.warmupFrames);
+    }
+}
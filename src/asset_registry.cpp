@@ -0,0 +1,234 @@
+#include "asset_registry.h"
+
+// room between packed images so filtering never samples a neighbour.
+const int ATLAS_PADDING = 1;
+const int ATLAS_MAX_WIDTH = 512;
+
+static TextureHandle addTextureEntry(AssetRegistry &registry, const TextureEntry &entry)
+{
+    if (!registry.freeHandles.empty())
+    {
+        TextureHandle handle = registry.freeHandles.back();
+        registry.freeHandles.pop_back();
+
+        registry.textures[handle] = entry;
+
+        return handle;
+    }
+
+    registry.textures.push_back(entry);
+
+    return (TextureHandle)registry.textures.size() - 1;
+}
+
+bool buildSpriteAtlas(AssetRegistry &registry, SDL_Renderer *renderer, const char *const *filePaths, int count)
+{
+    std::vector<SDL_Surface *> images(count, nullptr);
+    std::vector<SDL_Rect> regions(count);
+
+    int atlasWidth = 0;
+    int atlasHeight = 0;
+
+    // shelf packing: images are laid out left to right and a new shelf starts when a row is full.
+    int positionX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        images[i] = IMG_Load(filePaths[i]);
+        registry.misses++;
+
+        if (images[i] == nullptr)
+        {
+            printf("Failed to load image %s! SDL_image Error: %s\n", filePaths[i], IMG_GetError());
+            continue;
+        }
+
+        if (positionX > 0 && positionX + images[i]->w > ATLAS_MAX_WIDTH)
+        {
+            positionX = 0;
+            shelfY += shelfHeight + ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+
+        regions[i] = {positionX, shelfY, images[i]->w, images[i]->h};
+
+        positionX += images[i]->w + ATLAS_PADDING;
+        shelfHeight = SDL_max(shelfHeight, images[i]->h);
+
+        atlasWidth = SDL_max(atlasWidth, regions[i].x + regions[i].w);
+        atlasHeight = SDL_max(atlasHeight, regions[i].y + regions[i].h);
+    }
+
+    // without a renderer (headless runs) there is nothing to upload, the regions still give the sizes.
+    if (renderer != nullptr)
+    {
+        SDL_Surface *atlasSurface = nullptr;
+
+        if (atlasWidth > 0)
+        {
+            atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, atlasWidth, atlasHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+        }
+
+        if (atlasSurface != nullptr)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                if (images[i] != nullptr)
+                {
+                    SDL_SetSurfaceBlendMode(images[i], SDL_BLENDMODE_NONE);
+                    SDL_BlitSurface(images[i], NULL, atlasSurface, &regions[i]);
+                }
+            }
+
+            registry.atlasTexture = SDL_CreateTextureFromSurface(renderer, atlasSurface);
+
+            SDL_FreeSurface(atlasSurface);
+        }
+
+        if (registry.atlasTexture == nullptr)
+        {
+            printf("Failed to create sprite atlas! SDL Error: %s\n", SDL_GetError());
+        }
+    }
+
+    bool hasAtlas = renderer == nullptr || registry.atlasTexture != nullptr;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (images[i] == nullptr)
+        {
+            continue;
+        }
+
+        SDL_FreeSurface(images[i]);
+
+        if (hasAtlas)
+        {
+            // the registry holds the only reference, regions are never unloaded one by one.
+            addTextureEntry(registry, {filePaths[i], registry.atlasTexture, regions[i], 1, true});
+        }
+    }
+
+    return hasAtlas;
+}
+
+TextureHandle acquireTexture(AssetRegistry &registry, SDL_Renderer *renderer, const char *filePath)
+{
+    for (size_t i = 0; i < registry.textures.size(); i++)
+    {
+        TextureEntry &entry = registry.textures[i];
+
+        if (!entry.filePath.empty() && entry.filePath == filePath)
+        {
+            entry.references++;
+            registry.hits++;
+
+            return (TextureHandle)i;
+        }
+    }
+
+    registry.misses++;
+
+    TextureEntry entry = {filePath, nullptr, {0, 0, 0, 0}, 1, false};
+
+    // headless runs have no renderer, only the image size is kept.
+    if (renderer == nullptr)
+    {
+        SDL_Surface *image = IMG_Load(filePath);
+
+        if (image == nullptr)
+        {
+            printf("Failed to load image %s! SDL_image Error: %s\n", filePath, IMG_GetError());
+            return INVALID_TEXTURE;
+        }
+
+        entry.sourceBounds.w = image->w;
+        entry.sourceBounds.h = image->h;
+
+        SDL_FreeSurface(image);
+
+        return addTextureEntry(registry, entry);
+    }
+
+    entry.texture = IMG_LoadTexture(renderer, filePath);
+
+    if (entry.texture == nullptr)
+    {
+        printf("Failed to load texture %s! SDL_image Error: %s\n", filePath, IMG_GetError());
+        return INVALID_TEXTURE;
+    }
+
+    SDL_QueryTexture(entry.texture, NULL, NULL, &entry.sourceBounds.w, &entry.sourceBounds.h);
+
+    return addTextureEntry(registry, entry);
+}
+
+TextureHandle reacquireTexture(AssetRegistry &registry, SDL_Renderer *renderer, TextureHandle previousHandle, const char *filePath)
+{
+    TextureHandle handle = acquireTexture(registry, renderer, filePath);
+
+    releaseTexture(registry, previousHandle);
+
+    return handle;
+}
+
+void releaseTexture(AssetRegistry &registry, TextureHandle handle)
+{
+    if (handle == INVALID_TEXTURE)
+    {
+        return;
+    }
+
+    TextureEntry &entry = registry.textures[handle];
+
+    entry.references--;
+
+    if (entry.references == 0 && !entry.isAtlasRegion)
+    {
+        if (entry.texture != nullptr)
+        {
+            SDL_DestroyTexture(entry.texture);
+        }
+
+        entry.texture = nullptr;
+        entry.filePath.clear();
+
+        registry.freeHandles.push_back(handle);
+    }
+}
+
+Sprite getSprite(const AssetRegistry &registry, TextureHandle handle, int positionX, int positionY)
+{
+    if (handle == INVALID_TEXTURE)
+    {
+        return {nullptr, {positionX, positionY, 0, 0}, {0, 0, 0, 0}};
+    }
+
+    const TextureEntry &entry = registry.textures[handle];
+
+    return {entry.texture, {positionX, positionY, entry.sourceBounds.w, entry.sourceBounds.h}, entry.sourceBounds};
+}
+
+void destroyAssetRegistry(AssetRegistry &registry)
+{
+    printf("Texture cache: %d hits, %d misses\n", registry.hits, registry.misses);
+
+    for (TextureEntry &entry : registry.textures)
+    {
+        if (entry.texture != nullptr && !entry.isAtlasRegion)
+        {
+            SDL_DestroyTexture(entry.texture);
+        }
+    }
+
+    if (registry.atlasTexture != nullptr)
+    {
+        SDL_DestroyTexture(registry.atlasTexture);
+        registry.atlasTexture = nullptr;
+    }
+
+    registry.textures.clear();
+    registry.freeHandles.clear();
+}
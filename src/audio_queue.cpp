@@ -0,0 +1,160 @@
+#include "audio_queue.h"
+#include <algorithm>
+#include <iostream>
+
+// mixer channels reserved for every sound, channel groups are tagged with the sound id.
+const int SOUND_VOICES[SOUND_COUNT] = {4, 6, 2};
+
+// how long the audio thread sleeps once the ring is empty.
+const Uint32 AUDIO_POLL_MILLISECONDS = 2;
+
+static void playSoundEvent(const AudioQueue &queue, SoundEvent event)
+{
+    Mix_Chunk *chunk = queue.chunks[event.sound];
+
+    if (chunk == nullptr)
+    {
+        return;
+    }
+
+    int channel = Mix_GroupAvailable(event.sound);
+
+    // voice limit reached, the oldest voice of the group makes room.
+    if (channel == -1)
+    {
+        channel = Mix_GroupOldest(event.sound);
+    }
+
+    if (channel == -1)
+    {
+        return;
+    }
+
+    // every merged play adds a quarter of the single play volume, up to full volume.
+    int volume = std::min(MIX_MAX_VOLUME, queue.volumes[event.sound] * (3 + event.count) / 4);
+
+    Mix_Volume(channel, volume);
+    Mix_PlayChannel(channel, chunk, 0);
+}
+
+static int consumeSoundEvents(void *data)
+{
+    AudioQueue &queue = *(AudioQueue *)data;
+
+    while (queue.isRunning.load(std::memory_order_acquire))
+    {
+        Uint32 tail = queue.tail.load(std::memory_order_relaxed);
+        Uint32 head = queue.head.load(std::memory_order_acquire);
+
+        while (tail != head)
+        {
+            playSoundEvent(queue, queue.events[tail & (SOUND_QUEUE_CAPACITY - 1)]);
+            tail++;
+        }
+
+        queue.tail.store(tail, std::memory_order_release);
+
+        SDL_Delay(AUDIO_POLL_MILLISECONDS);
+    }
+
+    return 0;
+}
+
+void setQueuedSound(AudioQueue &queue, SoundId sound, Mix_Chunk *chunk, int volume)
+{
+    queue.chunks[sound] = chunk;
+    queue.volumes[sound] = volume;
+}
+
+bool startAudioQueue(AudioQueue &queue)
+{
+    int totalVoices = 0;
+
+    for (int sound = 0; sound < SOUND_COUNT; sound++)
+    {
+        totalVoices += SOUND_VOICES[sound];
+    }
+
+    Mix_AllocateChannels(totalVoices);
+
+    int firstChannel = 0;
+
+    for (int sound = 0; sound < SOUND_COUNT; sound++)
+    {
+        Mix_GroupChannels(firstChannel, firstChannel + SOUND_VOICES[sound] - 1, sound);
+        firstChannel += SOUND_VOICES[sound];
+    }
+
+    queue.head.store(0);
+    queue.tail.store(0);
+    queue.isRunning.store(true);
+
+    queue.thread = SDL_CreateThread(consumeSoundEvents, "audio events", &queue);
+
+    if (queue.thread == nullptr)
+    {
+        printf("Failed to start the audio thread: %s\n", SDL_GetError());
+        queue.isRunning.store(false);
+
+        return false;
+    }
+
+    return true;
+}
+
+void queueSound(AudioQueue &queue, SoundId sound)
+{
+    queue.pendingCounts[sound]++;
+}
+
+void flushSoundEvents(AudioQueue &queue)
+{
+    bool isRunning = queue.thread != nullptr;
+
+    for (int sound = 0; sound < SOUND_COUNT; sound++)
+    {
+        int count = queue.pendingCounts[sound];
+
+        if (count == 0)
+        {
+            continue;
+        }
+
+        queue.pendingCounts[sound] = 0;
+
+        if (!isRunning)
+        {
+            continue;
+        }
+
+        queue.mergedEvents += count - 1;
+
+        Uint32 head = queue.head.load(std::memory_order_relaxed);
+
+        // a full ring means the audio thread is stalled, losing a sound beats blocking the frame.
+        if (head - queue.tail.load(std::memory_order_acquire) == (Uint32)SOUND_QUEUE_CAPACITY)
+        {
+            queue.droppedEvents++;
+            continue;
+        }
+
+        queue.events[head & (SOUND_QUEUE_CAPACITY - 1)] = {(Uint8)sound, (Uint8)std::min(count, 255)};
+        queue.head.store(head + 1, std::memory_order_release);
+        queue.queuedEvents++;
+    }
+}
+
+void stopAudioQueue(AudioQueue &queue)
+{
+    if (queue.thread == nullptr)
+    {
+        return;
+    }
+
+    queue.isRunning.store(false, std::memory_order_release);
+
+    SDL_WaitThread(queue.thread, nullptr);
+    queue.thread = nullptr;
+
+    printf("Audio events: %d queued, %d merged, %d dropped\n", queue.queuedEvents, queue.mergedEvents, queue.droppedEvents);
+}
@@ -0,0 +1,166 @@
+#include "collision_grid.h"
+#include <algorithm>
+
+static int clampCell(int value, int last)
+{
+    if (value < 0)
+    {
+        return 0;
+    }
+
+    return value > last ? last : value;
+}
+
+// Anything outside the playfield is clamped into the border cells, clamping keeps overlapping
+// rects in overlapping cell ranges so no pair is missed.
+static void cellRange(const CollisionGrid &grid, int x, int y, int w, int h, int &firstColumn, int &lastColumn, int &firstRow, int &lastRow)
+{
+    firstColumn = clampCell(x / grid.cellSize, grid.columns - 1);
+    lastColumn = clampCell((x + w - 1) / grid.cellSize, grid.columns - 1);
+    firstRow = clampCell(y / grid.cellSize, grid.rows - 1);
+    lastRow = clampCell((y + h - 1) / grid.cellSize, grid.rows - 1);
+}
+
+void setupCollisionGrid(CollisionGrid &grid, int width, int height, int cellSize)
+{
+    grid.cellSize = cellSize;
+    grid.columns = (width + cellSize - 1) / cellSize;
+    grid.rows = (height + cellSize - 1) / cellSize;
+
+    grid.cellStarts.assign(grid.columns * grid.rows + 1, 0);
+    grid.cellCursors.assign(grid.columns * grid.rows, 0);
+    grid.cellItems.clear();
+}
+
+void buildCollisionGrid(CollisionGrid &grid, const AlienStore &aliens)
+{
+    int totalCells = grid.columns * grid.rows;
+    int totalAliens = alienCount(aliens);
+
+    std::fill(grid.cellStarts.begin(), grid.cellStarts.end(), 0);
+
+    int firstColumn, lastColumn, firstRow, lastRow;
+
+    // first pass counts how many aliens land in each cell.
+    for (int i = 0; i < totalAliens; i++)
+    {
+        if (aliens.isDestroyed[i])
+        {
+            continue;
+        }
+
+        cellRange(grid, aliens.x[i], aliens.y[i], aliens.w[i], aliens.h[i], firstColumn, lastColumn, firstRow, lastRow);
+
+        for (int row = firstRow; row <= lastRow; row++)
+        {
+            for (int column = firstColumn; column <= lastColumn; column++)
+            {
+                grid.cellStarts[row * grid.columns + column + 1]++;
+            }
+        }
+    }
+
+    for (int cell = 0; cell < totalCells; cell++)
+    {
+        grid.cellStarts[cell + 1] += grid.cellStarts[cell];
+        grid.cellCursors[cell] = grid.cellStarts[cell];
+    }
+
+    grid.cellItems.resize(grid.cellStarts[totalCells]);
+
+    // second pass writes the alien indices, in increasing order inside every cell.
+    for (int i = 0; i < totalAliens; i++)
+    {
+        if (aliens.isDestroyed[i])
+        {
+            continue;
+        }
+
+        cellRange(grid, aliens.x[i], aliens.y[i], aliens.w[i], aliens.h[i], firstColumn, lastColumn, firstRow, lastRow);
+
+        for (int row = firstRow; row <= lastRow; row++)
+        {
+            for (int column = firstColumn; column <= lastColumn; column++)
+            {
+                grid.cellItems[grid.cellCursors[row * grid.columns + column]++] = i;
+            }
+        }
+    }
+}
+
+int findAlienCollision(const CollisionGrid &grid, const AlienStore &aliens, const SDL_Rect &bounds)
+{
+    if (bounds.w <= 0 || bounds.h <= 0)
+    {
+        return -1;
+    }
+
+    int firstColumn, lastColumn, firstRow, lastRow;
+
+    cellRange(grid, bounds.x, bounds.y, bounds.w, bounds.h, firstColumn, lastColumn, firstRow, lastRow);
+
+    int hitIndex = -1;
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        for (int column = firstColumn; column <= lastColumn; column++)
+        {
+            int cell = row * grid.columns + column;
+
+            for (int item = grid.cellStarts[cell]; item < grid.cellStarts[cell + 1]; item++)
+            {
+                int i = grid.cellItems[item];
+
+                // indices are sorted inside a cell, nothing further in this cell can beat the current hit.
+                if (hitIndex != -1 && i >= hitIndex)
+                {
+                    break;
+                }
+
+                if (!aliens.isDestroyed[i] && hasIntersection(aliens.x[i], aliens.y[i], aliens.w[i], aliens.h[i], bounds))
+                {
+                    hitIndex = i;
+                }
+            }
+        }
+    }
+
+    return hitIndex;
+}
+
+typedef struct
+{
+    const CollisionGrid *grid;
+    const AlienStore *aliens;
+    const LaserStore *lasers;
+    float deltaY;
+    int offsetX;
+    int offsetY;
+    int *hits;
+} LaserHitPass;
+
+// lasers below this per batch cost less than handing them to another thread.
+const int LASER_HIT_BATCH_SIZE = 64;
+
+static void findLaserAlienHitsInRange(void *data, int begin, int end)
+{
+    const LaserHitPass &pass = *(const LaserHitPass *)data;
+    const LaserStore &lasers = *pass.lasers;
+
+    for (int i = begin; i < end; i++)
+    {
+        // the same float sum the caller stores in y, so the bounds match the moved laser exactly.
+        float y = lasers.y[i] + pass.deltaY;
+
+        SDL_Rect localBounds = {lasers.x[i] - pass.offsetX, (int)y - pass.offsetY, lasers.w[i], lasers.h[i]};
+
+        pass.hits[i] = findAlienCollision(*pass.grid, *pass.aliens, localBounds);
+    }
+}
+
+void findLaserAlienHits(JobSystem &jobs, const CollisionGrid &grid, const AlienStore &aliens, const LaserStore &lasers, float deltaY, int offsetX, int offsetY, int *hits)
+{
+    LaserHitPass pass = {&grid, &aliens, &lasers, deltaY, offsetX, offsetY, hits};
+
+    parallelFor(jobs, (int)laserCount(lasers), LASER_HIT_BATCH_SIZE, findLaserAlienHitsInRange, &pass);
+}
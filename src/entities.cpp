@@ -0,0 +1,381 @@
+#include "entities.h"
+
+void reserveAliens(AlienStore &aliens, size_t capacity)
+{
+    aliens.x.reserve(capacity);
+    aliens.y.reserve(capacity);
+    aliens.w.reserve(capacity);
+    aliens.h.reserve(capacity);
+    aliens.points.reserve(capacity);
+    aliens.spriteIndex.reserve(capacity);
+    aliens.isDestroyed.reserve(capacity);
+}
+
+void addAlien(AlienStore &aliens, int x, int y, int w, int h, int points, Uint8 spriteIndex)
+{
+    aliens.x.push_back(x);
+    aliens.y.push_back(y);
+    aliens.w.push_back(w);
+    aliens.h.push_back(h);
+    aliens.points.push_back(points);
+    aliens.spriteIndex.push_back(spriteIndex);
+    aliens.isDestroyed.push_back(false);
+}
+
+static void moveAlien(AlienStore &aliens, size_t from, size_t to)
+{
+    aliens.x[to] = aliens.x[from];
+    aliens.y[to] = aliens.y[from];
+    aliens.w[to] = aliens.w[from];
+    aliens.h[to] = aliens.h[from];
+    aliens.points[to] = aliens.points[from];
+    aliens.spriteIndex[to] = aliens.spriteIndex[from];
+    aliens.isDestroyed[to] = aliens.isDestroyed[from];
+}
+
+static void resizeAliens(AlienStore &aliens, size_t size)
+{
+    aliens.x.resize(size);
+    aliens.y.resize(size);
+    aliens.w.resize(size);
+    aliens.h.resize(size);
+    aliens.points.resize(size);
+    aliens.spriteIndex.resize(size);
+    aliens.isDestroyed.resize(size);
+}
+
+void removeDestroyedAliens(AlienStore &aliens, CompactionMode mode)
+{
+    size_t total = alienCount(aliens);
+    size_t kept = 0;
+
+    if (mode == COMPACTION_STABLE)
+    {
+        for (size_t i = 0; i < total; i++)
+        {
+            if (aliens.isDestroyed[i])
+            {
+                continue;
+            }
+
+            if (kept != i)
+            {
+                moveAlien(aliens, i, kept);
+            }
+
+            kept++;
+        }
+    }
+    else
+    {
+        kept = total;
+
+        for (size_t i = 0; i < kept;)
+        {
+            if (aliens.isDestroyed[i])
+            {
+                kept--;
+                moveAlien(aliens, kept, i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+
+    resizeAliens(aliens, kept);
+}
+
+int findLiveAlien(const AlienStore &aliens, int liveIndex)
+{
+    int totalAliens = alienCount(aliens);
+
+    for (int i = 0; i < totalAliens; i++)
+    {
+        if (!aliens.isDestroyed[i] && liveIndex-- == 0)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void clearAliens(AlienStore &aliens)
+{
+    aliens.x.clear();
+    aliens.y.clear();
+    aliens.w.clear();
+    aliens.h.clear();
+    aliens.points.clear();
+    aliens.spriteIndex.clear();
+    aliens.isDestroyed.clear();
+}
+
+// the local bounds of every alien still alive in the column, only rescanned when one of them dies.
+static void updateColumnExtents(Formation &formation, const AlienStore &aliens, int column)
+{
+    int totalAliens = alienCount(aliens);
+
+    int left = 0;
+    int right = 0;
+    bool isFirst = true;
+
+    for (int i = column; i < totalAliens; i += formation.columns)
+    {
+        if (aliens.isDestroyed[i])
+        {
+            continue;
+        }
+
+        if (isFirst || aliens.x[i] < left)
+        {
+            left = aliens.x[i];
+        }
+
+        if (isFirst || aliens.x[i] + aliens.w[i] > right)
+        {
+            right = aliens.x[i] + aliens.w[i];
+        }
+
+        isFirst = false;
+    }
+
+    formation.columnLeft[column] = left;
+    formation.columnRight[column] = right;
+}
+
+void setupFormation(Formation &formation, const AlienStore &aliens, int columns, int velocity)
+{
+    int totalAliens = alienCount(aliens);
+
+    formation.x = 0;
+    formation.y = 0;
+    formation.previousX = 0;
+    formation.previousY = 0;
+    formation.velocity = velocity;
+    formation.columns = columns;
+    formation.aliveCount = 0;
+
+    formation.columnAliveCount.assign(columns, 0);
+    formation.columnLeft.assign(columns, 0);
+    formation.columnRight.assign(columns, 0);
+
+    for (int i = 0; i < totalAliens; i++)
+    {
+        if (!aliens.isDestroyed[i])
+        {
+            formation.columnAliveCount[i % columns]++;
+            formation.aliveCount++;
+        }
+    }
+
+    for (int column = 0; column < columns; column++)
+    {
+        updateColumnExtents(formation, aliens, column);
+    }
+
+    formation.leftmostColumn = 0;
+    formation.rightmostColumn = columns - 1;
+
+    while (formation.leftmostColumn < columns && formation.columnAliveCount[formation.leftmostColumn] == 0)
+    {
+        formation.leftmostColumn++;
+    }
+
+    while (formation.rightmostColumn >= 0 && formation.columnAliveCount[formation.rightmostColumn] == 0)
+    {
+        formation.rightmostColumn--;
+    }
+}
+
+void destroyAlien(Formation &formation, AlienStore &aliens, int index)
+{
+    if (aliens.isDestroyed[index])
+    {
+        return;
+    }
+
+    aliens.isDestroyed[index] = true;
+    formation.aliveCount--;
+
+    int column = index % formation.columns;
+
+    formation.columnAliveCount[column]--;
+
+    updateColumnExtents(formation, aliens, column);
+
+    while (formation.leftmostColumn <= formation.rightmostColumn && formation.columnAliveCount[formation.leftmostColumn] == 0)
+    {
+        formation.leftmostColumn++;
+    }
+
+    while (formation.rightmostColumn >= formation.leftmostColumn && formation.columnAliveCount[formation.rightmostColumn] == 0)
+    {
+        formation.rightmostColumn--;
+    }
+}
+
+void moveFormation(Formation &formation, float deltaTime, int screenWidth)
+{
+    if (formation.aliveCount == 0)
+    {
+        return;
+    }
+
+    formation.x += formation.velocity * deltaTime;
+
+    int offsetX = getFormationOffsetX(formation);
+
+    int left = offsetX + formation.columnLeft[formation.leftmostColumn];
+    int right = offsetX + formation.columnRight[formation.rightmostColumn];
+
+    // only bounce when heading into the wall, a long frame that overshoots the edge must not flip twice.
+    if ((formation.velocity > 0 && right > screenWidth) || (formation.velocity < 0 && left < 0))
+    {
+        formation.velocity *= -1;
+        formation.y += 10;
+    }
+}
+
+void reserveLasers(LaserStore &lasers, size_t capacity)
+{
+    lasers.x.reserve(capacity);
+    lasers.y.reserve(capacity);
+    lasers.previousY.reserve(capacity);
+    lasers.w.reserve(capacity);
+    lasers.h.reserve(capacity);
+    lasers.isDestroyed.reserve(capacity);
+    lasers.slot.reserve(capacity);
+    lasers.droppedLasers = 0;
+
+    lasers.slotIndex.assign(capacity, 0);
+    lasers.slotGeneration.assign(capacity, 0);
+    lasers.freeSlots.resize(capacity);
+
+    // handed out from the back, so the first shots take the lowest slots.
+    for (size_t i = 0; i < capacity; i++)
+    {
+        lasers.freeSlots[i] = (Uint32)(capacity - 1 - i);
+    }
+}
+
+LaserHandle addLaser(LaserStore &lasers, const SDL_Rect &bounds)
+{
+    if (lasers.freeSlots.empty())
+    {
+        lasers.droppedLasers++;
+        return INVALID_LASER;
+    }
+
+    Uint32 slot = lasers.freeSlots.back();
+    lasers.freeSlots.pop_back();
+
+    lasers.slotGeneration[slot]++;
+    lasers.slotIndex[slot] = (Uint32)laserCount(lasers);
+
+    lasers.x.push_back(bounds.x);
+    lasers.y.push_back(bounds.y);
+    lasers.previousY.push_back(bounds.y);
+    lasers.w.push_back(bounds.w);
+    lasers.h.push_back(bounds.h);
+    lasers.isDestroyed.push_back(false);
+    lasers.slot.push_back(slot);
+
+    return {slot, lasers.slotGeneration[slot]};
+}
+
+static void freeLaserSlot(LaserStore &lasers, size_t index)
+{
+    Uint32 slot = lasers.slot[index];
+
+    lasers.slotGeneration[slot]++;
+    lasers.freeSlots.push_back(slot);
+}
+
+static void moveLaser(LaserStore &lasers, size_t from, size_t to)
+{
+    lasers.x[to] = lasers.x[from];
+    lasers.y[to] = lasers.y[from];
+    lasers.previousY[to] = lasers.previousY[from];
+    lasers.w[to] = lasers.w[from];
+    lasers.h[to] = lasers.h[from];
+    lasers.isDestroyed[to] = lasers.isDestroyed[from];
+    lasers.slot[to] = lasers.slot[from];
+
+    lasers.slotIndex[lasers.slot[to]] = (Uint32)to;
+}
+
+static void resizeLasers(LaserStore &lasers, size_t size)
+{
+    lasers.x.resize(size);
+    lasers.y.resize(size);
+    lasers.previousY.resize(size);
+    lasers.w.resize(size);
+    lasers.h.resize(size);
+    lasers.isDestroyed.resize(size);
+    lasers.slot.resize(size);
+}
+
+void removeDestroyedLasers(LaserStore &lasers, CompactionMode mode)
+{
+    size_t total = laserCount(lasers);
+    size_t kept = 0;
+
+    if (mode == COMPACTION_STABLE)
+    {
+        for (size_t i = 0; i < total; i++)
+        {
+            if (lasers.isDestroyed[i])
+            {
+                freeLaserSlot(lasers, i);
+                continue;
+            }
+
+            if (kept != i)
+            {
+                moveLaser(lasers, i, kept);
+            }
+
+            kept++;
+        }
+    }
+    else
+    {
+        kept = total;
+
+        for (size_t i = 0; i < kept;)
+        {
+            if (lasers.isDestroyed[i])
+            {
+                freeLaserSlot(lasers, i);
+
+                kept--;
+                moveLaser(lasers, kept, i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+
+    resizeLasers(lasers, kept);
+}
+
+void clearLasers(LaserStore &lasers)
+{
+    for (size_t i = 0; i < laserCount(lasers); i++)
+    {
+        freeLaserSlot(lasers, i);
+    }
+
+    lasers.x.clear();
+    lasers.y.clear();
+    lasers.previousY.clear();
+    lasers.w.clear();
+    lasers.h.clear();
+    lasers.isDestroyed.clear();
+    lasers.slot.clear();
+}
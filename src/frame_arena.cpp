@@ -0,0 +1,107 @@
+#include "frame_arena.h"
+#include <algorithm>
+#include <cstdarg>
+
+// heap blocks start with the link to the next one, padded so the payload keeps any alignment up to 16.
+const size_t OVERFLOW_HEADER_SIZE = 16;
+
+void createFrameArena(FrameArena &arena, size_t capacity)
+{
+    arena.memory = (Uint8 *)SDL_malloc(capacity);
+    arena.capacity = arena.memory != nullptr ? capacity : 0;
+    arena.used = 0;
+    arena.highWater = 0;
+    arena.overflowBlocks = nullptr;
+    arena.frameHeapAllocations = 0;
+    arena.heapAllocations = 0;
+    arena.framesWithHeapAllocations = 0;
+}
+
+static void freeOverflowBlocks(FrameArena &arena)
+{
+    while (arena.overflowBlocks != nullptr)
+    {
+        void *next = *(void **)arena.overflowBlocks;
+
+        SDL_free(arena.overflowBlocks);
+        arena.overflowBlocks = next;
+    }
+}
+
+void destroyFrameArena(FrameArena &arena)
+{
+    freeOverflowBlocks(arena);
+
+    SDL_free(arena.memory);
+    arena.memory = nullptr;
+    arena.capacity = 0;
+    arena.used = 0;
+}
+
+void resetFrameArena(FrameArena &arena)
+{
+    if (arena.frameHeapAllocations > 0)
+    {
+        arena.framesWithHeapAllocations++;
+    }
+
+    freeOverflowBlocks(arena);
+
+    arena.used = 0;
+    arena.frameHeapAllocations = 0;
+}
+
+void *allocateFromArena(FrameArena &arena, size_t size, size_t alignment)
+{
+    size_t start = (arena.used + alignment - 1) & ~(alignment - 1);
+
+    if (start + size <= arena.capacity)
+    {
+        arena.used = start + size;
+        arena.highWater = std::max(arena.highWater, arena.used);
+
+        return arena.memory + start;
+    }
+
+    Uint8 *block = (Uint8 *)SDL_malloc(OVERFLOW_HEADER_SIZE + size);
+
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+
+    *(void **)block = arena.overflowBlocks;
+    arena.overflowBlocks = block;
+
+    arena.frameHeapAllocations++;
+    arena.heapAllocations++;
+
+    return block + OVERFLOW_HEADER_SIZE;
+}
+
+const char *formatArenaText(FrameArena &arena, const char *format, ...)
+{
+    va_list arguments;
+
+    va_start(arguments, format);
+    int length = SDL_vsnprintf(nullptr, 0, format, arguments);
+    va_end(arguments);
+
+    char *text = (char *)allocateFromArena(arena, length + 1, 1);
+
+    if (text == nullptr)
+    {
+        return "";
+    }
+
+    va_start(arguments, format);
+    SDL_vsnprintf(text, length + 1, format, arguments);
+    va_end(arguments);
+
+    return text;
+}
+
+void printFrameArenaStats(const FrameArena &arena, const char *name)
+{
+    printf("%s arena: %d bytes of %d KB used at most, %d heap fallbacks in %d frames\n", name, (int)arena.highWater, (int)(arena.capacity / 1024), arena.heapAllocations, arena.framesWithHeapAllocations + (arena.frameHeapAllocations > 0));
+}
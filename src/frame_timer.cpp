@@ -0,0 +1,106 @@
+#include "frame_timer.h"
+#include <algorithm>
+#include <vector>
+
+const int HISTOGRAM_BUCKETS = 34;
+
+void startFrameTimer(FrameTimer &timer)
+{
+    timer.frequency = SDL_GetPerformanceFrequency();
+    timer.previousCounter = SDL_GetPerformanceCounter();
+    timer.nextSample = 0;
+    timer.sampleCount = 0;
+}
+
+float tickFrameTimer(FrameTimer &timer)
+{
+    Uint64 currentCounter = SDL_GetPerformanceCounter();
+
+    float frameTime = (float)((double)(currentCounter - timer.previousCounter) / timer.frequency);
+    timer.previousCounter = currentCounter;
+
+    timer.frameTimes[timer.nextSample] = frameTime;
+    timer.nextSample = (timer.nextSample + 1) % FRAME_TIMER_WINDOW;
+
+    if (timer.sampleCount < FRAME_TIMER_WINDOW)
+    {
+        timer.sampleCount++;
+    }
+
+    return frameTime;
+}
+
+// nearest-rank percentile, sortedTimes is only partially sorted as a side effect.
+static float findPercentile(std::vector<float> &sortedTimes, int percent)
+{
+    int index = ((int)sortedTimes.size() * percent + 99) / 100 - 1;
+    std::nth_element(sortedTimes.begin(), sortedTimes.begin() + index, sortedTimes.end());
+
+    return sortedTimes[index];
+}
+
+FrameStats computeFrameStats(const float *frameTimes, int count)
+{
+    FrameStats stats = {0, 0, 0, 0, 0, 0, count};
+
+    if (count == 0)
+    {
+        return stats;
+    }
+
+    std::vector<float> sortedTimes(frameTimes, frameTimes + count);
+
+    double total = 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        total += frameTimes[i];
+    }
+
+    stats.min = *std::min_element(frameTimes, frameTimes + count);
+    stats.max = *std::max_element(frameTimes, frameTimes + count);
+    stats.average = (float)(total / count);
+    stats.p50 = findPercentile(sortedTimes, 50);
+    stats.p90 = findPercentile(sortedTimes, 90);
+    stats.p99 = findPercentile(sortedTimes, 99);
+
+    return stats;
+}
+
+FrameStats getFrameStats(const FrameTimer &timer)
+{
+    return computeFrameStats(timer.frameTimes, timer.sampleCount);
+}
+
+void printFrameStats(const FrameTimer &timer)
+{
+    FrameStats stats = getFrameStats(timer);
+
+    printf("Frame times over the last %d frames (ms): min %.3f avg %.3f p50 %.3f p90 %.3f p99 %.3f max %.3f\n", stats.samples, stats.min * 1000, stats.average * 1000, stats.p50 * 1000, stats.p90 * 1000, stats.p99 * 1000, stats.max * 1000);
+
+    int buckets[HISTOGRAM_BUCKETS] = {};
+
+    for (int i = 0; i < timer.sampleCount; i++)
+    {
+        // one bucket per millisecond, the last one collects everything slower.
+        int bucket = (int)(timer.frameTimes[i] * 1000);
+        buckets[std::min(bucket, HISTOGRAM_BUCKETS - 1)]++;
+    }
+
+    for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++)
+    {
+        if (buckets[bucket] == 0)
+        {
+            continue;
+        }
+
+        if (bucket == HISTOGRAM_BUCKETS - 1)
+        {
+            printf("  >=%2d ms: %d\n", bucket, buckets[bucket]);
+        }
+        else
+        {
+            printf("  %2d-%2d ms: %d\n", bucket, bucket + 1, buckets[bucket]);
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#include "glyph_atlas.h"
+
+GlyphAtlas loadGlyphAtlas(SDL_Renderer *renderer, TTF_Font *font)
+{
+    GlyphAtlas atlas = {};
+
+    if (font == nullptr)
+    {
+        printf("TTF_OpenFont fontSquare: %s\n", TTF_GetError());
+        return atlas;
+    }
+
+    SDL_Color fontColor = {255, 255, 255};
+
+    SDL_Surface *glyphSurfaces[ATLAS_GLYPH_COUNT] = {};
+
+    int atlasWidth = 0;
+    int atlasHeight = 0;
+
+    for (int i = 0; i < ATLAS_GLYPH_COUNT; i++)
+    {
+        char glyphText[2] = {(char)(FIRST_ATLAS_GLYPH + i), '\0'};
+
+        int advance = 0;
+        TTF_GlyphMetrics(font, FIRST_ATLAS_GLYPH + i, NULL, NULL, NULL, NULL, &advance);
+        atlas.advances[i] = advance;
+
+        // space has nothing to draw, TTF refuses to render it on its own anyway.
+        if (glyphText[0] == ' ')
+        {
+            continue;
+        }
+
+        glyphSurfaces[i] = TTF_RenderUTF8_Blended(font, glyphText, fontColor);
+
+        if (glyphSurfaces[i] == nullptr)
+        {
+            continue;
+        }
+
+        atlasWidth += glyphSurfaces[i]->w;
+
+        if (glyphSurfaces[i]->h > atlasHeight)
+        {
+            atlasHeight = glyphSurfaces[i]->h;
+        }
+    }
+
+    atlas.lineHeight = TTF_FontHeight(font);
+
+    SDL_Surface *atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, atlasWidth > 0 ? atlasWidth : 1, atlasHeight > 0 ? atlasHeight : 1, 32, SDL_PIXELFORMAT_ARGB8888);
+
+    if (atlasSurface == nullptr)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to create glyph atlas surface! SDL Error: %s\n", SDL_GetError());
+        exit(3);
+    }
+
+    int positionX = 0;
+
+    for (int i = 0; i < ATLAS_GLYPH_COUNT; i++)
+    {
+        if (glyphSurfaces[i] == nullptr)
+        {
+            continue;
+        }
+
+        SDL_Rect glyphBounds = {positionX, 0, glyphSurfaces[i]->w, glyphSurfaces[i]->h};
+
+        // copy the glyph coverage as is instead of blending it over the empty atlas.
+        SDL_SetSurfaceBlendMode(glyphSurfaces[i], SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(glyphSurfaces[i], NULL, atlasSurface, &glyphBounds);
+
+        atlas.glyphBounds[i] = glyphBounds;
+        positionX += glyphBounds.w;
+
+        SDL_FreeSurface(glyphSurfaces[i]);
+    }
+
+    atlas.texture = SDL_CreateTextureFromSurface(renderer, atlasSurface);
+    if (atlas.texture == nullptr)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Unable to create glyph atlas texture! SDL Error: %s\n", SDL_GetError());
+    }
+
+    SDL_FreeSurface(atlasSurface);
+
+    return atlas;
+}
+
+int renderText(SDL_Renderer *renderer, const GlyphAtlas &atlas, const char *text, int positionX, int positionY)
+{
+    int startX = positionX;
+
+    for (const char *character = text; *character != '\0'; character++)
+    {
+        int glyph = (unsigned char)*character - FIRST_ATLAS_GLYPH;
+
+        if (glyph < 0 || glyph >= ATLAS_GLYPH_COUNT)
+        {
+            continue;
+        }
+
+        const SDL_Rect &glyphBounds = atlas.glyphBounds[glyph];
+
+        if (glyphBounds.w > 0)
+        {
+            SDL_Rect bounds = {positionX, positionY, glyphBounds.w, glyphBounds.h};
+
+            SDL_RenderCopy(renderer, atlas.texture, &glyphBounds, &bounds);
+        }
+
+        positionX += atlas.advances[glyph];
+    }
+
+    return positionX - startX;
+}
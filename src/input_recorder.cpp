@@ -0,0 +1,142 @@
+#include "input_recorder.h"
+
+// "SSRP" in little endian, followed by the format version.
+const Uint32 RECORDING_MAGIC = 0x50525353;
+// version 2: the seed drives the PCG32 streams instead of srand().
+const Uint32 RECORDING_VERSION = 2;
+
+// a day of play at 120 ticks per second, longer tick counts only come from damaged files.
+const Uint32 MAX_RECORDING_TICKS = 120 * 60 * 60 * 24;
+
+static void writeVarint(SDL_RWops *file, Uint32 value)
+{
+    while (value >= 0x80)
+    {
+        SDL_WriteU8(file, (Uint8)(value | 0x80));
+        value >>= 7;
+    }
+
+    SDL_WriteU8(file, (Uint8)value);
+}
+
+static Uint32 readVarint(SDL_RWops *file)
+{
+    Uint32 value = 0;
+
+    for (int shift = 0; shift < 32; shift += 7)
+    {
+        Uint8 byte = SDL_ReadU8(file);
+
+        value |= (Uint32)(byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0)
+        {
+            break;
+        }
+    }
+
+    return value;
+}
+
+void startInputRecording(InputRecording &recording, Uint32 seed, size_t expectedTicks)
+{
+    recording.seed = seed;
+    recording.inputs.clear();
+    recording.inputs.reserve(expectedTicks);
+}
+
+void recordInput(InputRecording &recording, Uint8 input)
+{
+    recording.inputs.push_back(input);
+}
+
+bool saveInputRecording(const InputRecording &recording, const char *filePath)
+{
+    SDL_RWops *file = SDL_RWFromFile(filePath, "wb");
+
+    if (file == nullptr)
+    {
+        printf("Failed to save recording %s! SDL Error: %s\n", filePath, SDL_GetError());
+        return false;
+    }
+
+    SDL_WriteLE32(file, RECORDING_MAGIC);
+    SDL_WriteLE32(file, RECORDING_VERSION);
+    SDL_WriteLE32(file, recording.seed);
+    SDL_WriteLE32(file, (Uint32)recording.inputs.size());
+
+    size_t totalTicks = recording.inputs.size();
+
+    for (size_t tick = 0; tick < totalTicks;)
+    {
+        Uint8 input = recording.inputs[tick];
+        Uint32 runLength = 1;
+
+        while (tick + runLength < totalTicks && recording.inputs[tick + runLength] == input)
+        {
+            runLength++;
+        }
+
+        SDL_WriteU8(file, input);
+        writeVarint(file, runLength);
+
+        tick += runLength;
+    }
+
+    SDL_RWclose(file);
+
+    return true;
+}
+
+bool loadInputRecording(InputRecording &recording, const char *filePath)
+{
+    SDL_RWops *file = SDL_RWFromFile(filePath, "rb");
+
+    if (file == nullptr)
+    {
+        printf("Failed to load recording %s! SDL Error: %s\n", filePath, SDL_GetError());
+        return false;
+    }
+
+    if (SDL_ReadLE32(file) != RECORDING_MAGIC || SDL_ReadLE32(file) != RECORDING_VERSION)
+    {
+        printf("Failed to load recording %s! Not a recording or unsupported version\n", filePath);
+        SDL_RWclose(file);
+        return false;
+    }
+
+    recording.seed = SDL_ReadLE32(file);
+
+    Uint32 totalTicks = SDL_ReadLE32(file);
+
+    // the count is read from the file, so it is checked before anything is allocated for it.
+    if (totalTicks > MAX_RECORDING_TICKS)
+    {
+        printf("Failed to load recording %s! The file is truncated or corrupted\n", filePath);
+        SDL_RWclose(file);
+        return false;
+    }
+
+    recording.inputs.clear();
+    recording.inputs.reserve(totalTicks);
+
+    while (recording.inputs.size() < totalTicks)
+    {
+        Uint8 input = SDL_ReadU8(file);
+        Uint32 runLength = readVarint(file);
+
+        // a truncated file reads as zero length runs.
+        if (runLength == 0 || recording.inputs.size() + runLength > totalTicks)
+        {
+            printf("Failed to load recording %s! The file is truncated or corrupted\n", filePath);
+            SDL_RWclose(file);
+            return false;
+        }
+
+        recording.inputs.insert(recording.inputs.end(), runLength, input);
+    }
+
+    SDL_RWclose(file);
+
+    return true;
+}
@@ -0,0 +1,256 @@
+#include "job_system.h"
+#include <algorithm>
+
+// batches per thread, a few more than one lets fast threads make up for slow ones.
+const int BATCHES_PER_THREAD = 4;
+
+// the queue of the running thread, every thread outside the workers submits through queue 0.
+static thread_local int currentQueue = 0;
+
+static bool pushJob(JobQueue &queue, const Job &job)
+{
+    SDL_AtomicLock(&queue.lock);
+
+    bool hasRoom = queue.bottom - queue.top < JOB_QUEUE_CAPACITY;
+
+    if (hasRoom)
+    {
+        queue.jobs[queue.bottom % JOB_QUEUE_CAPACITY] = job;
+        queue.bottom++;
+    }
+
+    SDL_AtomicUnlock(&queue.lock);
+
+    return hasRoom;
+}
+
+static bool popJob(JobQueue &queue, Job &job)
+{
+    SDL_AtomicLock(&queue.lock);
+
+    bool hasJob = queue.bottom > queue.top;
+
+    if (hasJob)
+    {
+        queue.bottom--;
+        job = queue.jobs[queue.bottom % JOB_QUEUE_CAPACITY];
+    }
+
+    // an empty ring starts over, so the positions never overflow.
+    if (queue.bottom == queue.top)
+    {
+        queue.bottom = 0;
+        queue.top = 0;
+    }
+
+    SDL_AtomicUnlock(&queue.lock);
+
+    return hasJob;
+}
+
+static bool stealJob(JobQueue &queue, Job &job)
+{
+    SDL_AtomicLock(&queue.lock);
+
+    bool hasJob = queue.bottom > queue.top;
+
+    if (hasJob)
+    {
+        job = queue.jobs[queue.top % JOB_QUEUE_CAPACITY];
+        queue.top++;
+    }
+
+    SDL_AtomicUnlock(&queue.lock);
+
+    return hasJob;
+}
+
+// own queue first, then the others in turn starting with the next one.
+static bool findJob(JobSystem &jobs, Job &job)
+{
+    if (popJob(jobs.queues[currentQueue], job))
+    {
+        return true;
+    }
+
+    for (int i = 1; i < jobs.threadCount; i++)
+    {
+        if (stealJob(jobs.queues[(currentQueue + i) % jobs.threadCount], job))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void runJob(const Job &job)
+{
+    job.function(job.data, job.begin, job.end);
+
+    SDL_AtomicAdd(job.pending, -1);
+}
+
+static int runJobWorker(void *data)
+{
+    JobSystem &jobs = *(JobSystem *)data;
+
+    currentQueue = SDL_AtomicAdd(&jobs.startedWorkers, 1) + 1;
+
+    Job job;
+
+    while (true)
+    {
+        if (findJob(jobs, job))
+        {
+            runJob(job);
+            continue;
+        }
+
+        if (SDL_AtomicGet(&jobs.isStopping))
+        {
+            break;
+        }
+
+        SDL_SemWait(jobs.wakeSignal);
+    }
+
+    return 0;
+}
+
+bool startJobSystem(JobSystem &jobs, int threadCount)
+{
+    jobs.threadCount = 1;
+
+    for (JobQueue &queue : jobs.queues)
+    {
+        queue.lock = 0;
+        queue.top = 0;
+        queue.bottom = 0;
+    }
+
+    SDL_AtomicSet(&jobs.startedWorkers, 0);
+    SDL_AtomicSet(&jobs.isStopping, 0);
+
+    jobs.wakeSignal = SDL_CreateSemaphore(0);
+
+    if (jobs.wakeSignal == nullptr)
+    {
+        printf("Failed to start the job system: %s\n", SDL_GetError());
+        return false;
+    }
+
+    // set before any worker starts and never changed while they run.
+    jobs.threadCount = SDL_clamp(threadCount, 1, MAX_JOB_THREADS);
+
+    for (int i = 1; i < jobs.threadCount; i++)
+    {
+        jobs.threads[i] = SDL_CreateThread(runJobWorker, "job worker", &jobs);
+
+        if (jobs.threads[i] == nullptr)
+        {
+            printf("Failed to start job worker %d, running single threaded: %s\n", i, SDL_GetError());
+
+            // the workers started so far stop again, so every queue still has an owner.
+            SDL_AtomicSet(&jobs.isStopping, 1);
+
+            for (int j = 1; j < i; j++)
+            {
+                SDL_SemPost(jobs.wakeSignal);
+            }
+
+            for (int j = 1; j < i; j++)
+            {
+                SDL_WaitThread(jobs.threads[j], nullptr);
+            }
+
+            jobs.threadCount = 1;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void parallelFor(JobSystem &jobs, int count, int minBatchSize, JobFunction function, void *data)
+{
+    int batchCount = std::min(count / std::max(minBatchSize, 1), jobs.threadCount * BATCHES_PER_THREAD);
+
+    if (jobs.threadCount <= 1 || batchCount < 2)
+    {
+        function(data, 0, count);
+        return;
+    }
+
+    int batchSize = (count + batchCount - 1) / batchCount;
+
+    SDL_atomic_t pending;
+    SDL_AtomicSet(&pending, 0);
+
+    JobQueue &queue = jobs.queues[currentQueue];
+
+    int queuedBatches = 0;
+
+    // the first batch is run right here, the rest is queued for the workers to steal.
+    for (int begin = batchSize; begin < count; begin += batchSize)
+    {
+        Job job = {function, data, begin, std::min(begin + batchSize, count), &pending};
+
+        SDL_AtomicAdd(&pending, 1);
+
+        if (pushJob(queue, job))
+        {
+            queuedBatches++;
+        }
+        else
+        {
+            runJob(job);
+        }
+    }
+
+    for (int i = 0; i < std::min(queuedBatches, jobs.threadCount - 1); i++)
+    {
+        SDL_SemPost(jobs.wakeSignal);
+    }
+
+    function(data, 0, batchSize);
+
+    Job job;
+
+    while (SDL_AtomicGet(&pending) > 0)
+    {
+        if (findJob(jobs, job))
+        {
+            runJob(job);
+        }
+        else
+        {
+#ifdef SDL_CPUPauseInstruction
+            SDL_CPUPauseInstruction();
+#endif
+        }
+    }
+}
+
+void stopJobSystem(JobSystem &jobs)
+{
+    SDL_AtomicSet(&jobs.isStopping, 1);
+
+    for (int i = 1; i < jobs.threadCount; i++)
+    {
+        SDL_SemPost(jobs.wakeSignal);
+    }
+
+    for (int i = 1; i < jobs.threadCount; i++)
+    {
+        SDL_WaitThread(jobs.threads[i], nullptr);
+    }
+
+    jobs.threadCount = 1;
+
+    if (jobs.wakeSignal != nullptr)
+    {
+        SDL_DestroySemaphore(jobs.wakeSignal);
+        jobs.wakeSignal = nullptr;
+    }
+}
@@ -2,54 +2,136 @@
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_mixer.h>
 #include <SDL2/SDL_ttf.h>
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include "sdl_starter.h"
 #include "sdl_assets_loader.h"
+#include "entities.h"
+#include "collision_grid.h"
+#include "glyph_atlas.h"
+#include "asset_registry.h"
+#include "sprite_batch.h"
+#include "frame_timer.h"
+#include "input_recorder.h"
+#include "random.h"
+#include "profiler.h"
+#include "audio_queue.h"
+#include "sound_bank.h"
+#include "music_stream.h"
+#include "frame_arena.h"
+#include "allocation_tracker.h"
+#include "simulation_thread.h"
+#include "job_system.h"
 
 bool isGamePaused;
 bool isGameOver;
 
+// the simulation always advances in steps of 1/120 s, independent of the frame rate.
+const float FIXED_DELTA_TIME = 1.0f / 120.0f;
+const float MAX_FRAME_TIME = 0.25f;
+
+FrameTimer frameTimer;
+
+// Per-frame scratch memory, one arena per thread so neither needs a lock: frameArena belongs to the
+// main thread and render(), simulationArena to whichever thread runs update(), the simulation thread
+// in windowed runs and the main thread in headless and training runs. Both are reset once per frame
+// or headless tick.
+FrameArena frameArena;
+FrameArena simulationArena;
+
+// runs update() for the frame while the main thread renders the previous one.
+SimulationThread simulationThread;
+
+// --threads sets how many threads share the laser collision pass, the one running update() included.
+JobSystem jobs;
+
+// --track-allocations counts heap allocations per frame and phase, --zero-alloc-test also fails
+// the run (exit code 1) when a frame past the warmup allocates.
+AllocationTracker allocationTracker;
+
+// F3 toggles the profiler and its overlay, F4 exports a trace, --profile <file> profiles from the start and exports on quit.
+Profiler profiler;
+const char *tracePath = nullptr;
+
+// --record keeps every simulated tick's input and saves it on quit, --dump-state writes one line per tick.
+InputRecording inputRecording;
+const char *recordingPath = nullptr;
+FILE *stateDumpFile = nullptr;
+int simulatedTicks = 0;
+
+// player input for one simulation tick, read from the keyboard or generated in headless runs.
+enum
+{
+    INPUT_LEFT = 1,
+    INPUT_RIGHT = 2,
+    INPUT_FIRE = 4
+};
+
 SDL_Window *window = nullptr;
 SDL_Renderer *renderer = nullptr;
 
 Mix_Chunk *laserSound = nullptr;
 Mix_Chunk *explosionSound = nullptr;
 Mix_Chunk *pauseSound = nullptr;
-Mix_Music *music = nullptr;
+
+// update() only queues sounds, they are played from the audio thread.
+AudioQueue audioQueue;
+
+// --bake-sounds converts these, in SoundId order, into the bank the game maps at startup.
+const char *SOUND_PATHS[SOUND_COUNT] = {"res/sounds/laser.wav", "res/sounds/explosion.wav", "res/sounds/magic.wav"};
+const char *SOUND_BANK_PATH = "res/sounds/sounds.bank";
+SoundBank soundBank;
+
+// streamed from disk, --music-buffer sets how many milliseconds are read ahead.
+MusicStream music;
 
 TTF_Font *fontSquare = nullptr;
 
-SDL_Texture *scoreTexture = nullptr;
-SDL_Rect scoreBounds;
+GlyphAtlas hudAtlas;
 
-SDL_Texture *liveTexture = nullptr;
-SDL_Rect liveBounds;
+SpriteBatch spriteBatch;
 
 SDL_Texture *pauseTexture = nullptr;
 SDL_Rect pauseBounds;
 
+AssetRegistry assets;
+
+TextureHandle shipTexture = INVALID_TEXTURE;
+TextureHandle playerTexture = INVALID_TEXTURE;
+TextureHandle structureTexture = INVALID_TEXTURE;
+TextureHandle alienTextures[3] = {INVALID_TEXTURE, INVALID_TEXTURE, INVALID_TEXTURE};
+
+const char *ALIEN_SPRITE_PATHS[3] = {"res/sprites/alien_1.png", "res/sprites/alien_2.png", "res/sprites/alien_3.png"};
+
+// packed into one texture at startup so the whole playfield draws with a single texture binding.
+const char *ATLAS_SPRITE_PATHS[6] = {"res/sprites/alien_1.png", "res/sprites/alien_2.png", "res/sprites/alien_3.png", "res/sprites/mystery.png", "res/sprites/spaceship.png", "res/sprites/structure.png"};
+
 Sprite shipSprite;
 Sprite playerSprite;
-Sprite alienSprite1;
-Sprite alienSprite2;
-Sprite alienSprite3;
 Sprite structureSprite;
 
-typedef struct
-{
-    SDL_Rect bounds;
-    bool isDestroyed;
-} Laser;
+// shared by every alien, AlienStore::spriteIndex points into this table.
+Sprite alienSprites[3];
+
+// preallocated at startup, far more than even the fastest training wave keeps alive at once.
+const size_t MAX_LASERS = 1024;
 
-std::vector<Laser> playerLasers;
-std::vector<Laser> alienLasers;
+LaserStore playerLasers;
+LaserStore alienLasers;
 
 float lastTimePlayerShoot;
 float lastTimeAliensShoot;
 
+float playerFireInterval = 0.35f;
+float alienFireInterval = 0.6f;
+
+Random alienFireRandom;
+
 typedef struct
 {
+    float x;
+    float previousX;
     Sprite sprite;
     int lives;
     int speed;
@@ -61,6 +143,7 @@ Player player;
 typedef struct
 {
     float x;
+    float previousX;
     Sprite sprite;
     int points;
     int velocityX;
@@ -81,122 +164,162 @@ typedef struct
 
 std::vector<Structure> structures;
 
-typedef struct
-{
-    float x;
-    Sprite sprite;
-    int points;
-    int velocity;
-    bool isDestroyed;
-} Alien;
+AlienStore aliens;
+Formation formation;
+
+// lasers are independent so the cheaper unordered removal is fine.
+const CompactionMode LASERS_COMPACTION = COMPACTION_SWAP_AND_POP;
 
-std::vector<Alien> aliens;
+// broadphase for player lasers, built over the formation slots once per wave.
+CollisionGrid alienGrid;
 
-bool shouldChangeVelocity = false;
+// shape of every wave, the arcade 5 x 11 unless the training workload scripts bigger ones.
+int waveRows = 5;
+int waveColumns = 11;
 
-std::vector<Alien> createAliens()
+// Scripted waves of the PGO training workload: bigger formations and faster fire than the arcade
+// wave, so the collision and compaction paths get trained with many aliens and lasers alive.
+typedef struct
 {
-    alienSprite1 = loadSprite(renderer, "res/sprites/alien_1.png", 0, 0);
-    alienSprite2 = loadSprite(renderer, "res/sprites/alien_2.png", 0, 0);
-    alienSprite3 = loadSprite(renderer, "res/sprites/alien_3.png", 0, 0);
+    int rows;
+    int columns;
+    float playerFireInterval;
+    float alienFireInterval;
+    int ticks;
+} TrainingWave;
+
+const TrainingWave TRAINING_WAVES[] = {
+    {5, 11, 0.35f, 0.6f, 20000},
+    {10, 22, 0.05f, 0.1f, 20000},
+    {20, 40, 0.02f, 0.02f, 20000},
+    {40, 60, 0.01f, 0.01f, 20000},
+};
+
+void createAliens()
+{
+    for (int i = 0; i < 3; i++)
+    {
+        alienTextures[i] = reacquireTexture(assets, renderer, alienTextures[i], ALIEN_SPRITE_PATHS[i]);
+        alienSprites[i] = getSprite(assets, alienTextures[i], 0, 0);
+    }
 
-    std::vector<Alien> aliens;
+    // the store is refilled in place, after the first wave the columns already have the capacity.
+    // we increase the capacity of each column to 5 * 11 = 55 aliens for the arcade wave.
+    clearAliens(aliens);
+    reserveAliens(aliens, waveRows * waveColumns);
 
-    // we should use .reserve when creating a vector to avoid requiring allocation, reserve does: Increase the capacity
-    //  of the vector (the total number of elements that the vector can hold without requiring reallocation
-    // we increase the vector capacity to 5 * 11 = 55 aliens struct.
-    aliens.reserve(55);
+    // bigger waves are packed tighter so they still fit the same area as the arcade one.
+    int spacingX = std::min(60, 660 / waveColumns);
+    int spacingY = std::min(50, 250 / waveRows);
 
     int positionX;
     int positionY = 50;
     int alienPoints = 8;
 
-    Sprite actualSprite;
+    Uint8 spriteIndex;
 
-    for (int row = 0; row < 5; row++)
+    for (int row = 0; row < waveRows; row++)
     {
         positionX = 150;
 
         switch (row)
         {
         case 0:
-            actualSprite = alienSprite3;
+            spriteIndex = 2;
             break;
 
         case 1:
         case 2:
-            actualSprite = alienSprite2;
+            spriteIndex = 1;
             break;
 
         default:
-            actualSprite = alienSprite1;
+            spriteIndex = 0;
         }
 
-        for (int columns = 0; columns < 11; columns++)
+        SDL_Rect spriteBounds = alienSprites[spriteIndex].textureBounds;
+
+        for (int columns = 0; columns < waveColumns; columns++)
         {
-            actualSprite.textureBounds.x = positionX;
-            actualSprite.textureBounds.y = positionY;
+            addAlien(aliens, positionX, positionY, spriteBounds.w, spriteBounds.h, alienPoints, spriteIndex);
 
-            Alien actualAlien = {(float)positionX, actualSprite, alienPoints, 100, false};
+            positionX += spacingX;
+        }
 
-            aliens.push_back(actualAlien);
-            positionX += 60;
+        if (alienPoints > 1)
+        {
+            alienPoints--;
         }
 
-        alienPoints--;
-        positionY += 50;
+        positionY += spacingY;
     }
+}
+
+void setupAliens()
+{
+    createAliens();
 
-    return aliens;
+    setupFormation(formation, aliens, waveColumns, 100);
+
+    buildCollisionGrid(alienGrid, aliens);
 }
 
 void aliensMovement(float deltaTime)
 {
-    for (Alien &alien : aliens)
-    {
-        alien.x += alien.velocity * deltaTime;
-        alien.sprite.textureBounds.x = alien.x;
+    ProfileScope profileScope(profiler, PROFILE_ALIENS_MOVEMENT);
 
-        float alienPosition = alien.sprite.textureBounds.x + alien.sprite.textureBounds.w;
+    moveFormation(formation, deltaTime, SCREEN_WIDTH);
+}
 
-        if ((!shouldChangeVelocity && alienPosition > SCREEN_WIDTH) || alienPosition < alien.sprite.textureBounds.w)
-        {
-            shouldChangeVelocity = true;
-            break;
-        }
+void quitGame()
+{
+    stopSimulationThread(simulationThread);
+    stopJobSystem(jobs);
+
+    printFrameStats(frameTimer);
+
+    printAllocationStats(allocationTracker);
+    printFrameArenaStats(frameArena, "Frame");
+    printFrameArenaStats(simulationArena, "Simulation");
+    destroyFrameArena(frameArena);
+    destroyFrameArena(simulationArena);
+
+    if (playerLasers.droppedLasers + alienLasers.droppedLasers > 0)
+    {
+        printf("Laser pool full, %d player and %d alien shots dropped\n", playerLasers.droppedLasers, alienLasers.droppedLasers);
     }
 
-    if (shouldChangeVelocity)
+    if (recordingPath != nullptr)
     {
-        for (Alien &alien : aliens)
-        {
-            alien.velocity *= -1;
-            alien.sprite.textureBounds.y += 10;
-        }
+        saveInputRecording(inputRecording, recordingPath);
+    }
 
-        shouldChangeVelocity = false;
+    if (stateDumpFile != nullptr)
+    {
+        fclose(stateDumpFile);
     }
-}
 
-void quitGame()
-{
-    SDL_DestroyTexture(shipSprite.texture);
-    SDL_DestroyTexture(playerSprite.texture);
-    SDL_DestroyTexture(structureSprite.texture);
-    SDL_DestroyTexture(alienSprite1.texture);
-    SDL_DestroyTexture(alienSprite2.texture);
-    SDL_DestroyTexture(alienSprite3.texture);
-    SDL_DestroyTexture(scoreTexture);
-    SDL_DestroyTexture(liveTexture);
+    if (tracePath != nullptr)
+    {
+        exportChromeTrace(profiler, tracePath);
+    }
+
+    destroyAssetRegistry(assets);
+    SDL_DestroyTexture(hudAtlas.texture);
     SDL_DestroyTexture(pauseTexture);
 
     // Close SDL_image
     IMG_Quit();
 
+    stopAudioQueue(audioQueue);
+    closeMusicStream(music);
+
     Mix_FreeChunk(laserSound);
     Mix_FreeChunk(explosionSound);
     Mix_FreeChunk(pauseSound);
-    Mix_FreeMusic(music);
+
+    // the chunks pointed into the bank.
+    closeSoundBank(soundBank);
 
     // Close SDL_mixer
     Mix_CloseAudio();
@@ -217,12 +340,13 @@ void setupStructures()
     SDL_Rect structureBounds3 = {200 * 3, SCREEN_HEIGHT - 120, 56, 33};
     SDL_Rect structureBounds4 = {200 * 4, SCREEN_HEIGHT - 120, 56, 33};
 
-    structureSprite = loadSprite(renderer, "res/sprites/structure.png", 120, SCREEN_HEIGHT - 120);
+    structureTexture = reacquireTexture(assets, renderer, structureTexture, "res/sprites/structure.png");
+    structureSprite = getSprite(assets, structureTexture, 120, SCREEN_HEIGHT - 120);
 
-    structures.push_back({{structureSprite.texture, structureBounds}, 5, false});
-    structures.push_back({{structureSprite.texture, structureBounds2}, 5, false});
-    structures.push_back({{structureSprite.texture, structureBounds3}, 5, false});
-    structures.push_back({{structureSprite.texture, structureBounds4}, 5, false});
+    structures.push_back({{structureSprite.texture, structureBounds, structureSprite.sourceBounds}, 5, false});
+    structures.push_back({{structureSprite.texture, structureBounds2, structureSprite.sourceBounds}, 5, false});
+    structures.push_back({{structureSprite.texture, structureBounds3, structureSprite.sourceBounds}, 5, false});
+    structures.push_back({{structureSprite.texture, structureBounds4, structureSprite.sourceBounds}, 5, false});
 }
 
 void resetGame()
@@ -230,24 +354,19 @@ void resetGame()
     player.lives = 3;
     player.score = 0;
 
-    std::string liveString = "lives: " + std::to_string(player.lives);
-    updateTextureText(liveTexture, liveString.c_str(), fontSquare, renderer);
-
-    std::string scoreString = "score: " + std::to_string(player.score);
-    updateTextureText(scoreTexture, scoreString.c_str(), fontSquare, renderer);
-
     structures.clear();
     setupStructures();
 
-    aliens.clear();
-    aliens = createAliens();
+    setupAliens();
 
-    playerLasers.clear();
-    alienLasers.clear();
+    clearLasers(playerLasers);
+    clearLasers(alienLasers);
 }
 
 void handleEvents()
 {
+    ProfileScope profileScope(profiler, PROFILE_HANDLE_EVENTS);
+
     SDL_Event event;
 
     while (SDL_PollEvent(&event))
@@ -255,31 +374,43 @@ void handleEvents()
         if (event.type == SDL_QUIT || event.key.keysym.sym == SDLK_ESCAPE)
         {
             quitGame();
-            exit(0);
+            exit(getAllocationTestStatus(allocationTracker));
         }
 
         if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_f)
         {
             isGamePaused = !isGamePaused;
-            Mix_PlayChannel(-1, pauseSound, 0);
+            queueSound(audioQueue, SOUND_PAUSE);
+        }
+
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3)
+        {
+            profiler.isEnabled = !profiler.isEnabled;
+        }
+
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F4)
+        {
+            exportChromeTrace(profiler, "trace.json");
         }
 
         if (isGameOver && event.type == SDL_KEYDOWN)
         {
             isGameOver = false;
             resetGame();
-            Mix_PlayChannel(-1, pauseSound, 0);
+            queueSound(audioQueue, SOUND_PAUSE);
         }
     }
 }
 
-void checkCollisionBetweenStructureAndLaser(Laser &laser)
+void checkCollisionBetweenStructureAndLaser(LaserStore &lasers, size_t index)
 {
+    SDL_Rect bounds = getLaserBounds(lasers, index);
+
     for (Structure &structure : structures)
     {
-        if (!structure.isDestroyed && SDL_HasIntersection(&structure.sprite.textureBounds, &laser.bounds))
+        if (!structure.isDestroyed && SDL_HasIntersection(&structure.sprite.textureBounds, &bounds))
         {
-            laser.isDestroyed = true;
+            lasers.isDestroyed[index] = true;
 
             structure.lives--;
 
@@ -288,7 +419,7 @@ void checkCollisionBetweenStructureAndLaser(Laser &laser)
                 structure.isDestroyed = true;
             }
 
-            Mix_PlayChannel(-1, explosionSound, 0);
+            queueSound(audioQueue, SOUND_EXPLOSION);
 
             break;
         }
@@ -297,55 +428,71 @@ void checkCollisionBetweenStructureAndLaser(Laser &laser)
 
 void removeDestroyedElements()
 {
-    for (auto iterator = aliens.begin(); iterator != aliens.end();)
+    ProfileScope profileScope(profiler, PROFILE_REMOVE_DESTROYED);
+
+    removeDestroyedLasers(playerLasers, LASERS_COMPACTION);
+    removeDestroyedLasers(alienLasers, LASERS_COMPACTION);
+}
+
+// positions at the start of the tick, render() blends from these to the current ones.
+void savePreviousState()
+{
+    player.previousX = player.x;
+    mysteryShip.previousX = mysteryShip.x;
+
+    formation.previousX = formation.x;
+    formation.previousY = formation.y;
+
+    playerLasers.previousY = playerLasers.y;
+    alienLasers.previousY = alienLasers.y;
+}
+
+Uint8 readKeyboardInput()
+{
+    const Uint8 *currentKeyStates = SDL_GetKeyboardState(NULL);
+
+    Uint8 input = 0;
+
+    if (currentKeyStates[SDL_SCANCODE_A])
     {
-        if (iterator->isDestroyed)
-        {
-            aliens.erase(iterator);
-        }
-        else
-        {
-            iterator++;
-        }
+        input |= INPUT_LEFT;
     }
 
-    for (auto iterator = playerLasers.begin(); iterator != playerLasers.end();)
+    if (currentKeyStates[SDL_SCANCODE_D])
     {
-        if (iterator->isDestroyed)
-        {
-            playerLasers.erase(iterator);
-        }
-        else
-        {
-            iterator++;
-        }
+        input |= INPUT_RIGHT;
     }
 
-    for (auto iterator = alienLasers.begin(); iterator != alienLasers.end();)
+    if (currentKeyStates[SDL_SCANCODE_SPACE])
     {
-        if (iterator->isDestroyed)
-        {
-            alienLasers.erase(iterator);
-        }
-        else
-        {
-            iterator++;
-        }
+        input |= INPUT_FIRE;
     }
+
+    return input;
 }
 
-void update(float deltaTime)
+// headless runs keep firing and sweep the ship across the screen, so every system gets exercised.
+Uint8 getAutopilotInput(int tick)
 {
-    const Uint8 *currentKeyStates = SDL_GetKeyboardState(NULL);
+    return INPUT_FIRE | ((tick / 240) % 2 == 0 ? INPUT_LEFT : INPUT_RIGHT);
+}
+
+void update(float deltaTime, Uint8 input)
+{
+    ProfileScope profileScope(profiler, PROFILE_UPDATE);
+
+    savePreviousState();
 
-    if (currentKeyStates[SDL_SCANCODE_A] && player.sprite.textureBounds.x > 0)
+    if ((input & INPUT_LEFT) && player.sprite.textureBounds.x > 0)
     {
-        player.sprite.textureBounds.x -= player.speed * deltaTime;
+        player.x -= player.speed * deltaTime;
+        player.sprite.textureBounds.x = player.x;
     }
 
-    else if (currentKeyStates[SDL_SCANCODE_D] && player.sprite.textureBounds.x < SCREEN_WIDTH - player.sprite.textureBounds.w)
+    else if ((input & INPUT_RIGHT) && player.sprite.textureBounds.x < SCREEN_WIDTH - player.sprite.textureBounds.w)
     {
-        player.sprite.textureBounds.x += player.speed * deltaTime;
+        player.x += player.speed * deltaTime;
+        player.sprite.textureBounds.x = player.x;
     }
 
     if (!mysteryShip.shouldMove)
@@ -372,108 +519,110 @@ void update(float deltaTime)
         mysteryShip.sprite.textureBounds.x = mysteryShip.x;
     }
 
-    if (currentKeyStates[SDL_SCANCODE_SPACE])
+    if (input & INPUT_FIRE)
     {
         lastTimePlayerShoot += deltaTime;
 
-        if (lastTimePlayerShoot >= 0.35)
+        if (lastTimePlayerShoot >= playerFireInterval)
         {
             SDL_Rect laserBounds = {player.sprite.textureBounds.x + 20, player.sprite.textureBounds.y - player.sprite.textureBounds.h, 4, 16};
 
-            playerLasers.push_back({laserBounds, false});
+            addLaser(playerLasers, laserBounds);
 
             lastTimePlayerShoot = 0;
 
-            Mix_PlayChannel(-1, laserSound, 0);
+            queueSound(audioQueue, SOUND_LASER);
         }
     }
 
-    for (Laser &laser : playerLasers)
-    {
-        laser.bounds.y -= 400 * deltaTime;
+    float playerLaserDeltaY = -400 * deltaTime;
 
-        if (laser.bounds.y < 0)
-            laser.isDestroyed = true;
+    // the alien each player laser hits this tick, found in parallel before the hits are applied.
+    ArenaVector<int> playerLaserHits(simulationArena);
+    playerLaserHits.resize(laserCount(playerLasers));
 
-        if (!mysteryShip.isDestroyed && SDL_HasIntersection(&mysteryShip.sprite.textureBounds, &laser.bounds))
-        {
-            laser.isDestroyed = true;
+    findLaserAlienHits(jobs, alienGrid, aliens, playerLasers, playerLaserDeltaY, getFormationOffsetX(formation), formation.y, playerLaserHits.data());
 
-            player.score += mysteryShip.points;
+    for (size_t i = 0; i < laserCount(playerLasers); i++)
+    {
+        playerLasers.y[i] += playerLaserDeltaY;
+
+        if (playerLasers.y[i] < 0)
+            playerLasers.isDestroyed[i] = true;
 
-            std::string scoreString = "score: " + std::to_string(player.score);
+        SDL_Rect laserBounds = getLaserBounds(playerLasers, i);
 
-            updateTextureText(scoreTexture, scoreString.c_str(), fontSquare, renderer);
+        if (!mysteryShip.isDestroyed && SDL_HasIntersection(&mysteryShip.sprite.textureBounds, &laserBounds))
+        {
+            playerLasers.isDestroyed[i] = true;
 
+            player.score += mysteryShip.points;
             mysteryShip.isDestroyed = true;
 
-            Mix_PlayChannel(-1, explosionSound, 0);
+            queueSound(audioQueue, SOUND_EXPLOSION);
 
             break;
         }
 
-        for (Alien &alien : aliens)
-        {
-            if (!alien.isDestroyed && SDL_HasIntersection(&alien.sprite.textureBounds, &laser.bounds))
-            {
-                alien.isDestroyed = true;
-                laser.isDestroyed = true;
-
-                player.score += alien.points;
+        int hitAlienIndex = playerLaserHits[i];
 
-                std::string scoreString = "score: " + std::to_string(player.score);
+        // an earlier laser of this tick destroyed that alien, the next one behind it may still be hit.
+        if (hitAlienIndex != -1 && aliens.isDestroyed[hitAlienIndex])
+        {
+            SDL_Rect localLaserBounds = {laserBounds.x - getFormationOffsetX(formation), laserBounds.y - formation.y, laserBounds.w, laserBounds.h};
 
-                updateTextureText(scoreTexture, scoreString.c_str(), fontSquare, renderer);
+            hitAlienIndex = findAlienCollision(alienGrid, aliens, localLaserBounds);
+        }
 
-                Mix_PlayChannel(-1, explosionSound, 0);
+        if (hitAlienIndex != -1)
+        {
+            destroyAlien(formation, aliens, hitAlienIndex);
+            playerLasers.isDestroyed[i] = true;
 
-                break;
-            }
+            player.score += aliens.points[hitAlienIndex];
+            queueSound(audioQueue, SOUND_EXPLOSION);
         }
 
-        checkCollisionBetweenStructureAndLaser(laser);
+        checkCollisionBetweenStructureAndLaser(playerLasers, i);
     }
 
     lastTimeAliensShoot += deltaTime;
 
-    if (aliens.size() > 0 && lastTimeAliensShoot >= 0.6)
+    if (formation.aliveCount > 0 && lastTimeAliensShoot >= alienFireInterval)
     {
-        int randomAlienIndex = rand() % aliens.size();
+        int randomAlienIndex = findLiveAlien(aliens, nextRandomBounded(alienFireRandom, formation.aliveCount));
 
-        Alien alienShooter = aliens[randomAlienIndex];
+        SDL_Rect alienShooter = getAlienBounds(aliens, formation, randomAlienIndex);
 
-        SDL_Rect laserBounds = {alienShooter.sprite.textureBounds.x + 20, alienShooter.sprite.textureBounds.y + alienShooter.sprite.textureBounds.h, 4, 16};
+        SDL_Rect laserBounds = {alienShooter.x + 20, alienShooter.y + alienShooter.h, 4, 16};
 
-        alienLasers.push_back({laserBounds, false});
+        addLaser(alienLasers, laserBounds);
 
         lastTimeAliensShoot = 0;
 
-        Mix_PlayChannel(-1, laserSound, 0);
+        queueSound(audioQueue, SOUND_LASER);
     }
 
-    for (Laser &laser : alienLasers)
+    for (size_t i = 0; i < laserCount(alienLasers); i++)
     {
-        laser.bounds.y += 400 * deltaTime;
+        alienLasers.y[i] += 400 * deltaTime;
 
-        if (laser.bounds.y > SCREEN_HEIGHT)
-            laser.isDestroyed = true;
+        if (alienLasers.y[i] > SCREEN_HEIGHT)
+            alienLasers.isDestroyed[i] = true;
 
-        if (player.lives > 0 && SDL_HasIntersection(&player.sprite.textureBounds, &laser.bounds))
+        SDL_Rect laserBounds = getLaserBounds(alienLasers, i);
+
+        if (player.lives > 0 && SDL_HasIntersection(&player.sprite.textureBounds, &laserBounds))
         {
-            laser.isDestroyed = true;
+            alienLasers.isDestroyed[i] = true;
 
             player.lives--;
-
-            std::string liveString = "lives: " + std::to_string(player.lives);
-
-            updateTextureText(liveTexture, liveString.c_str(), fontSquare, renderer);
-
-            Mix_PlayChannel(-1, explosionSound, 0);
+            queueSound(audioQueue, SOUND_EXPLOSION);
 
             break;
         }
 
-        checkCollisionBetweenStructureAndLaser(laser);
+        checkCollisionBetweenStructureAndLaser(alienLasers, i);
     }
 
     aliensMovement(deltaTime);
@@ -481,34 +630,150 @@ void update(float deltaTime)
     removeDestroyedElements();
 }
 
-void render()
+// a laser as render() needs it, y is blended from previousY.
+typedef struct
 {
-    SDL_SetRenderDrawColor(renderer, 29, 29, 27, 255);
-    SDL_RenderClear(renderer);
+    int x;
+    float y;
+    float previousY;
+    int w;
+    int h;
+} LaserSnapshot;
+
+// Everything render() draws, copied out of the simulation state at the end of a simulated frame.
+// The simulation thread fills one snapshot while render() draws the other, so rendering never
+// reads state the simulation is changing. The vectors keep their capacity, refilling them does
+// not allocate once they have grown to the wave size.
+typedef struct
+{
+    // how far the renderer is between the last two simulation ticks.
+    float alpha;
+    Player player;
+    MysteryShip mysteryShip;
+    float formationX;
+    float formationPreviousX;
+    int formationY;
+    int formationPreviousY;
+    // live aliens only, in formation space.
+    std::vector<SDL_Rect> alienBounds;
+    std::vector<Uint8> alienSpriteIndices;
+    std::vector<Sprite> structureSprites;
+    // alien lasers first, then the player's.
+    std::vector<LaserSnapshot> lasers;
+} RenderSnapshot;
+
+static void captureLasers(RenderSnapshot &snapshot, const LaserStore &lasers)
+{
+    for (size_t i = 0; i < laserCount(lasers); i++)
+    {
+        if (!lasers.isDestroyed[i])
+        {
+            snapshot.lasers.push_back({lasers.x[i], lasers.y[i], lasers.previousY[i], lasers.w[i], lasers.h[i]});
+        }
+    }
+}
+
+void captureRenderSnapshot(RenderSnapshot &snapshot, float alpha)
+{
+    snapshot.alpha = alpha;
+    snapshot.player = player;
+    snapshot.mysteryShip = mysteryShip;
 
-    SDL_QueryTexture(scoreTexture, NULL, NULL, &scoreBounds.w, &scoreBounds.h);
-    scoreBounds.x = 200;
-    scoreBounds.y = scoreBounds.h / 2;
-    SDL_RenderCopy(renderer, scoreTexture, NULL, &scoreBounds);
+    snapshot.formationX = formation.x;
+    snapshot.formationPreviousX = formation.previousX;
+    snapshot.formationY = formation.y;
+    snapshot.formationPreviousY = formation.previousY;
 
-    SDL_QueryTexture(liveTexture, NULL, NULL, &liveBounds.w, &liveBounds.h);
-    liveBounds.x = 600;
-    liveBounds.y = liveBounds.h / 2;
-    SDL_RenderCopy(renderer, liveTexture, NULL, &liveBounds);
+    snapshot.alienBounds.clear();
+    snapshot.alienSpriteIndices.clear();
 
-    if (!mysteryShip.isDestroyed)
+    for (size_t i = 0; i < alienCount(aliens); i++)
     {
-        renderSprite(renderer, mysteryShip.sprite);
+        if (!aliens.isDestroyed[i])
+        {
+            snapshot.alienBounds.push_back({aliens.x[i], aliens.y[i], aliens.w[i], aliens.h[i]});
+            snapshot.alienSpriteIndices.push_back(aliens.spriteIndex[i]);
+        }
     }
 
-    for (Alien &alien : aliens)
+    snapshot.structureSprites.clear();
+
+    for (Structure &structure : structures)
     {
-        if (!alien.isDestroyed)
+        if (!structure.isDestroyed)
         {
-            renderSprite(renderer, alien.sprite);
+            snapshot.structureSprites.push_back(structure.sprite);
         }
     }
 
+    snapshot.lasers.clear();
+
+    captureLasers(snapshot, alienLasers);
+    captureLasers(snapshot, playerLasers);
+}
+
+float interpolate(float previous, float current, float alpha)
+{
+    return previous + (current - previous) * alpha;
+}
+
+// Only reads the snapshot, so it can run while the simulation thread advances the game.
+void render(const RenderSnapshot &snapshot)
+{
+    ProfileScope profileScope(profiler, PROFILE_RENDER);
+
+    float alpha = snapshot.alpha;
+
+    SDL_SetRenderDrawColor(renderer, 29, 29, 27, 255);
+    SDL_RenderClear(renderer);
+
+    // the HUD is composed from the glyph atlas every frame, a score change costs nothing.
+    char hudText[32];
+
+    SDL_snprintf(hudText, sizeof(hudText), "score: %d", snapshot.player.score);
+    renderText(renderer, hudAtlas, hudText, 200, hudAtlas.lineHeight / 2);
+
+    SDL_snprintf(hudText, sizeof(hudText), "lives: %d", snapshot.player.lives);
+    renderText(renderer, hudAtlas, hudText, 600, hudAtlas.lineHeight / 2);
+
+    // every sprite comes from the atlas and every laser is a solid quad, so the playfield is
+    // submitted as one geometry call per texture.
+    beginSpriteBatch(spriteBatch, renderer);
+
+    if (!snapshot.mysteryShip.isDestroyed)
+    {
+        Sprite interpolatedSprite = snapshot.mysteryShip.sprite;
+        interpolatedSprite.textureBounds.x = interpolate(snapshot.mysteryShip.previousX, snapshot.mysteryShip.x, alpha);
+
+        batchSprite(spriteBatch, interpolatedSprite);
+    }
+
+    int formationX = (int)SDL_floorf(interpolate(snapshot.formationPreviousX, snapshot.formationX, alpha));
+    int formationY = (int)SDL_floorf(interpolate(snapshot.formationPreviousY, snapshot.formationY, alpha));
+
+    for (size_t i = 0; i < snapshot.alienBounds.size(); i++)
+    {
+        SDL_Rect bounds = snapshot.alienBounds[i];
+        bounds.x += formationX;
+        bounds.y += formationY;
+
+        const Sprite &alienSprite = alienSprites[snapshot.alienSpriteIndices[i]];
+
+        batchSprite(spriteBatch, alienSprite.texture, alienSprite.sourceBounds, bounds);
+    }
+
+    for (const Sprite &structureSprite : snapshot.structureSprites)
+    {
+        batchSprite(spriteBatch, structureSprite);
+    }
+
+    Sprite interpolatedSprite = snapshot.player.sprite;
+    interpolatedSprite.textureBounds.x = interpolate(snapshot.player.previousX, snapshot.player.x, alpha);
+
+    batchSprite(spriteBatch, interpolatedSprite);
+
+    flushSpriteBatch(spriteBatch);
+
     SDL_SetRenderDrawColor(renderer, 243, 216, 63, 255);
 
     SDL_RenderDrawLine(renderer, 0, 1, SCREEN_WIDTH, 1);
@@ -516,114 +781,500 @@ void render()
     SDL_RenderDrawLine(renderer, 0, 0, 0, SCREEN_HEIGHT);
     SDL_RenderDrawLine(renderer, SCREEN_WIDTH - 1, 0, SCREEN_WIDTH - 1, SCREEN_HEIGHT);
 
-    for (Laser &laser : alienLasers)
+    SDL_Color laserColor = {243, 216, 63, 255};
+
+    for (const LaserSnapshot &laser : snapshot.lasers)
     {
-        if (!laser.isDestroyed)
-        {
-            SDL_RenderFillRect(renderer, &laser.bounds);
-        }
+        SDL_Rect bounds = {laser.x, (int)interpolate(laser.previousY, laser.y, alpha), laser.w, laser.h};
+
+        batchRect(spriteBatch, bounds, laserColor);
+    }
+
+    flushSpriteBatch(spriteBatch);
+
+    if (isGamePaused)
+    {
+        SDL_RenderCopy(renderer, pauseTexture, NULL, &pauseBounds);
     }
 
-    for (Laser &laser : playerLasers)
+    renderProfilerOverlay(renderer, profiler, hudAtlas);
+
+    SDL_RenderPresent(renderer);
+}
+
+Uint32 hashBytes(Uint32 hash, const void *data, size_t size)
+{
+    const Uint8 *bytes = (const Uint8 *)data;
+
+    // FNV-1a
+    for (size_t i = 0; i < size; i++)
     {
-        if (!laser.isDestroyed)
-        {
-            SDL_RenderFillRect(renderer, &laser.bounds);
-        }
+        hash = (hash ^ bytes[i]) * 16777619u;
     }
 
+    return hash;
+}
+
+// one line per tick, diffing the dumps of two runs points at the first tick where they diverge.
+void dumpGameState(FILE *file, int tick)
+{
+    Uint32 hash = 2166136261u;
+
+    hash = hashBytes(hash, &player.x, sizeof(player.x));
+    hash = hashBytes(hash, &mysteryShip.x, sizeof(mysteryShip.x));
+    hash = hashBytes(hash, aliens.isDestroyed.data(), aliens.isDestroyed.size());
+    hash = hashBytes(hash, playerLasers.x.data(), playerLasers.x.size() * sizeof(int));
+    hash = hashBytes(hash, playerLasers.y.data(), playerLasers.y.size() * sizeof(float));
+    hash = hashBytes(hash, alienLasers.x.data(), alienLasers.x.size() * sizeof(int));
+    hash = hashBytes(hash, alienLasers.y.data(), alienLasers.y.size() * sizeof(float));
+
     for (Structure &structure : structures)
     {
-        if (!structure.isDestroyed)
+        hash = hashBytes(hash, &structure.lives, sizeof(structure.lives));
+    }
+
+    fprintf(file, "%d score=%d lives=%d aliens=%d formation=%.3f,%d player=%.3f lasers=%d,%d hash=%08x\n", tick, player.score, player.lives, formation.aliveCount, formation.x, formation.y, player.x, (int)laserCount(playerLasers), (int)laserCount(alienLasers), hash);
+}
+
+// one fixed step of the game, the windowed, headless and replay loops all advance through here.
+void simulateTick(Uint8 input)
+{
+    if (recordingPath != nullptr)
+    {
+        recordInput(inputRecording, input);
+    }
+
+    update(FIXED_DELTA_TIME, input);
+
+    if (stateDumpFile != nullptr)
+    {
+        dumpGameState(stateDumpFile, simulatedTicks);
+    }
+
+    simulatedTicks++;
+
+    // this is failling when the player dies.
+    if (formation.aliveCount == 0 || player.lives == 0)
+    {
+        isGameOver = true;
+    }
+}
+
+// The simulation thread's work for one frame: up to `ticks` fixed steps, then the snapshot the
+// next frame renders. A game over ends the frame early, ticksRun tells how many steps happened.
+typedef struct
+{
+    int ticks;
+    int ticksRun;
+    Uint8 input;
+    float alpha;
+    RenderSnapshot *snapshot;
+} SimulationFrame;
+
+void runSimulationFrame(void *data)
+{
+    SimulationFrame &frame = *(SimulationFrame *)data;
+
+    resetFrameArena(simulationArena);
+
+    frame.ticksRun = 0;
+
+    while (frame.ticksRun < frame.ticks && !isGameOver)
+    {
+        simulateTick(frame.input);
+        frame.ticksRun++;
+    }
+
+    captureRenderSnapshot(*frame.snapshot, frame.alpha);
+}
+
+// Runs the simulation as fast as possible with no window, renderer or mixer, for benchmarks and soak tests.
+// Inputs come from the replay when there is one, otherwise from the autopilot. A game over restarts
+// right away, in a recorded session no tick happens between the game over and the restart either.
+void runHeadless(int totalTicks, const InputRecording *replay)
+{
+    int gameOvers = 0;
+
+    if (replay != nullptr)
+    {
+        totalTicks = replay->inputs.size();
+    }
+
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+
+    startFrameTimer(frameTimer);
+
+    for (int tick = 0; tick < totalTicks; tick++)
+    {
+        beginProfilerFrame(profiler);
+        beginAllocationFrame(allocationTracker);
+        resetFrameArena(frameArena);
+        resetFrameArena(simulationArena);
+
+        simulateTick(replay != nullptr ? replay->inputs[tick] : getAutopilotInput(tick));
+
+        flushSoundEvents(audioQueue);
+
+        tickFrameTimer(frameTimer);
+
+        if (isGameOver)
         {
-            renderSprite(renderer, structure.sprite);
+            gameOvers++;
+            isGameOver = false;
+            resetGame();
         }
     }
 
-    renderSprite(renderer, player.sprite);
+    double seconds = (double)(SDL_GetPerformanceCounter() - startCounter) / SDL_GetPerformanceFrequency();
 
-    if (isGamePaused)
+    printf("Headless: %d ticks in %.3f s (%.0f ticks/s), %d game overs\n", totalTicks, seconds, totalTicks / seconds, gameOvers);
+}
+
+// The PGO training workload: the scripted waves played headless by the autopilot. Prints the
+// percentiles of every tick time of the run, the before/after comparison of tools/pgo.sh reads them.
+void runTraining()
+{
+    std::vector<float> tickTimes;
+    int gameOvers = 0;
+
+    for (const TrainingWave &wave : TRAINING_WAVES)
     {
-        SDL_RenderCopy(renderer, pauseTexture, NULL, &pauseBounds);
+        tickTimes.reserve(tickTimes.size() + wave.ticks);
     }
 
-    SDL_RenderPresent(renderer);
+    startFrameTimer(frameTimer);
+
+    for (const TrainingWave &wave : TRAINING_WAVES)
+    {
+        waveRows = wave.rows;
+        waveColumns = wave.columns;
+        playerFireInterval = wave.playerFireInterval;
+        alienFireInterval = wave.alienFireInterval;
+
+        resetGame();
+
+        for (int tick = 0; tick < wave.ticks; tick++)
+        {
+            beginProfilerFrame(profiler);
+            beginAllocationFrame(allocationTracker);
+            resetFrameArena(frameArena);
+            resetFrameArena(simulationArena);
+
+            simulateTick(getAutopilotInput(tick));
+
+            flushSoundEvents(audioQueue);
+
+            tickTimes.push_back(tickFrameTimer(frameTimer));
+
+            if (isGameOver)
+            {
+                gameOvers++;
+                isGameOver = false;
+                resetGame();
+            }
+        }
+    }
+
+    FrameStats stats = computeFrameStats(tickTimes.data(), tickTimes.size());
+
+    printf("Training: %d ticks, %d game overs, tick times (us): min %.2f avg %.2f p50 %.2f p90 %.2f p99 %.2f max %.2f\n", stats.samples, gameOvers, stats.min * 1000000, stats.average * 1000000, stats.p50 * 1000000, stats.p90 * 1000000, stats.p99 * 1000000, stats.max * 1000000);
 }
 
 int main(int argc, char *args[])
 {
-    window = SDL_CreateWindow("My Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
+    bool isHeadless = false;
+    bool isTraining = false;
+    int headlessTicks = 100000;
+    int audioBufferSamples = DEFAULT_AUDIO_BUFFER_SAMPLES;
+    int musicBufferMilliseconds = DEFAULT_MUSIC_BUFFER_MILLISECONDS;
+    bool isTrackingAllocations = false;
+    bool isZeroAllocationTest = false;
+    int threadCount = SDL_GetCPUCount();
+
+    const char *replayPath = nullptr;
+    const char *stateDumpPath = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (SDL_strcmp(args[i], "--headless") == 0)
+        {
+            isHeadless = true;
+        }
+        else if (SDL_strcmp(args[i], "--ticks") == 0 && i + 1 < argc)
+        {
+            headlessTicks = SDL_atoi(args[++i]);
+        }
+        else if (SDL_strcmp(args[i], "--record") == 0 && i + 1 < argc)
+        {
+            recordingPath = args[++i];
+        }
+        else if (SDL_strcmp(args[i], "--replay") == 0 && i + 1 < argc)
+        {
+            replayPath = args[++i];
+        }
+        else if (SDL_strcmp(args[i], "--dump-state") == 0 && i + 1 < argc)
+        {
+            stateDumpPath = args[++i];
+        }
+        else if (SDL_strcmp(args[i], "--profile") == 0 && i + 1 < argc)
+        {
+            tracePath = args[++i];
+        }
+        else if (SDL_strcmp(args[i], "--training") == 0)
+        {
+            isTraining = true;
+            isHeadless = true;
+        }
+        else if (SDL_strcmp(args[i], "--audio-buffer") == 0 && i + 1 < argc)
+        {
+            audioBufferSamples = SDL_atoi(args[++i]);
+        }
+        else if (SDL_strcmp(args[i], "--music-buffer") == 0 && i + 1 < argc)
+        {
+            musicBufferMilliseconds = SDL_atoi(args[++i]);
+        }
+        else if (SDL_strcmp(args[i], "--track-allocations") == 0)
+        {
+            isTrackingAllocations = true;
+        }
+        else if (SDL_strcmp(args[i], "--zero-alloc-test") == 0)
+        {
+            isTrackingAllocations = true;
+            isZeroAllocationTest = true;
+        }
+        else if (SDL_strcmp(args[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threadCount = SDL_atoi(args[++i]);
+        }
+        else if (SDL_strcmp(args[i], "--bake-sounds") == 0)
+        {
+            return bakeSoundBank(SOUND_PATHS, SOUND_COUNT, SOUND_BANK_PATH, AUDIO_FREQUENCY, AUDIO_FORMAT, AUDIO_CHANNELS) ? 0 : 1;
+        }
+    }
+
+    // before anything else, SDL only accepts new memory functions while it has not allocated yet.
+    if (isTrackingAllocations)
+    {
+        startAllocationTracker(allocationTracker, isZeroAllocationTest, DEFAULT_ALLOCATION_WARMUP_FRAMES);
+    }
+
+    Uint32 seed = (Uint32)time(NULL);
+
+    InputRecording replay;
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    // replays run headless, as fast as the simulation allows.
+    if (replayPath != nullptr)
+    {
+        if (!loadInputRecording(replay, replayPath))
+        {
+            return 1;
+        }
+
+        seed = replay.seed;
+        isHeadless = true;
+    }
+
+    inputRecording.seed = seed;
+
+    if (recordingPath != nullptr)
+    {
+        // headless runs know their length, the others get an hour before the buffer has to grow.
+        size_t expectedTicks = DEFAULT_RECORDING_TICKS;
+
+        if (replayPath != nullptr)
+        {
+            expectedTicks = std::max(expectedTicks, replay.inputs.size());
+        }
+        else if (isHeadless && !isTraining)
+        {
+            expectedTicks = std::max(expectedTicks, (size_t)SDL_max(headlessTicks, 0));
+        }
+
+        startInputRecording(inputRecording, seed, expectedTicks);
+    }
+
+    startProfiler(profiler, tracePath != nullptr);
+
+    createFrameArena(frameArena, DEFAULT_FRAME_ARENA_SIZE);
+    createFrameArena(simulationArena, DEFAULT_FRAME_ARENA_SIZE);
+
+    if (stateDumpPath != nullptr)
+    {
+        stateDumpFile = fopen(stateDumpPath, "w");
+
+        if (stateDumpFile == nullptr)
+        {
+            printf("Failed to open state dump %s\n", stateDumpPath);
+            return 1;
+        }
+    }
 
-    if (startSDL(window, renderer) > 0)
+    if (isHeadless)
     {
-        return 1;
+        if (startHeadlessSDL() > 0)
+        {
+            return 1;
+        }
     }
+    else
+    {
+        window = SDL_CreateWindow("My Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
 
-    fontSquare = TTF_OpenFont("res/fonts/square_sans_serif_7.ttf", 30);
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
 
-    updateTextureText(scoreTexture, "Score: 0", fontSquare, renderer);
+        if (startSDL(window, renderer, audioBufferSamples) > 0)
+        {
+            return 1;
+        }
 
-    updateTextureText(liveTexture, "Lives: 3", fontSquare, renderer);
+        fontSquare = TTF_OpenFont("res/fonts/square_sans_serif_7.ttf", 30);
 
-    updateTextureText(pauseTexture, "Game Paused", fontSquare, renderer);
+        hudAtlas = loadGlyphAtlas(renderer, fontSquare);
 
-    SDL_QueryTexture(pauseTexture, NULL, NULL, &pauseBounds.w, &pauseBounds.h);
-    pauseBounds.x = 350;
-    pauseBounds.y = pauseBounds.h / 2 + 25;
+        updateTextureText(pauseTexture, "Game Paused", fontSquare, renderer);
 
-    laserSound = loadSound("res/sounds/laser.wav");
-    pauseSound = loadSound("res/sounds/magic.wav");
-    explosionSound = loadSound("res/sounds/explosion.wav");
+        SDL_QueryTexture(pauseTexture, NULL, NULL, &pauseBounds.w, &pauseBounds.h);
+        pauseBounds.x = 350;
+        pauseBounds.y = pauseBounds.h / 2 + 25;
 
-    Mix_VolumeChunk(explosionSound, MIX_MAX_VOLUME / 2);
+        // without a usable bank the WAV files are decoded at startup as before.
+        if (openSoundBank(soundBank, SOUND_BANK_PATH))
+        {
+            laserSound = loadBankSound(soundBank, SOUND_LASER);
+            explosionSound = loadBankSound(soundBank, SOUND_EXPLOSION);
+            pauseSound = loadBankSound(soundBank, SOUND_PAUSE);
+        }
+        else
+        {
+            laserSound = loadSound(SOUND_PATHS[SOUND_LASER]);
+            explosionSound = loadSound(SOUND_PATHS[SOUND_EXPLOSION]);
+            pauseSound = loadSound(SOUND_PATHS[SOUND_PAUSE]);
+        }
 
-    music = loadMusic("res/music/music.wav");
+        setQueuedSound(audioQueue, SOUND_LASER, laserSound, MIX_MAX_VOLUME);
+        setQueuedSound(audioQueue, SOUND_EXPLOSION, explosionSound, MIX_MAX_VOLUME / 2);
+        setQueuedSound(audioQueue, SOUND_PAUSE, pauseSound, MIX_MAX_VOLUME);
 
-    // Mix_VolumeMusic(MIX_MAX_VOLUME / 2);
+        startAudioQueue(audioQueue);
 
-    // Mix_PlayMusic(music, -1);
+        if (openMusicStream(music, "res/music/music.wav", musicBufferMilliseconds, true))
+        {
+            playMusicStream(music, MIX_MAX_VOLUME / 2);
+        }
+    }
+
+    // with no renderer in headless runs, the sprites only provide their sizes to the simulation.
+    buildSpriteAtlas(assets, renderer, ATLAS_SPRITE_PATHS, 6);
+
+    shipTexture = acquireTexture(assets, renderer, "res/sprites/mystery.png");
+    shipSprite = getSprite(assets, shipTexture, SCREEN_WIDTH, 40);
 
-    shipSprite = loadSprite(renderer, "res/sprites/mystery.png", SCREEN_WIDTH, 40);
+    mysteryShip = {SCREEN_WIDTH, SCREEN_WIDTH, shipSprite, 50, -200, false, false};
 
-    mysteryShip = {SCREEN_WIDTH, shipSprite, 50, -200, false, false};
+    setupCollisionGrid(alienGrid, SCREEN_WIDTH, SCREEN_HEIGHT, 64);
 
-    aliens = createAliens();
+    reserveLasers(playerLasers, MAX_LASERS);
+    reserveLasers(alienLasers, MAX_LASERS);
 
-    playerSprite = loadSprite(renderer, "res/sprites/spaceship.png", SCREEN_WIDTH / 2, SCREEN_HEIGHT - 40);
+    // without its workers the job system still runs every pass on the calling thread.
+    startJobSystem(jobs, threadCount);
 
-    player = {playerSprite, 3, 600, 0};
+    setupAliens();
+
+    playerTexture = acquireTexture(assets, renderer, "res/sprites/spaceship.png");
+    playerSprite = getSprite(assets, playerTexture, SCREEN_WIDTH / 2, SCREEN_HEIGHT - 40);
+
+    player = {SCREEN_WIDTH / 2, SCREEN_WIDTH / 2, playerSprite, 3, 600, 0};
 
     setupStructures();
 
-    Uint32 previousFrameTime = SDL_GetTicks();
-    Uint32 currentFrameTime = previousFrameTime;
-    float deltaTime = 0.0f;
+    // Activating random seed, recorded so a replay draws the same numbers.
+    seedRandom(alienFireRandom, seed, RANDOM_STREAM_ALIEN_FIRE);
+
+    if (isTraining)
+    {
+        runTraining();
+
+        quitGame();
+
+        return getAllocationTestStatus(allocationTracker);
+    }
+
+    if (isHeadless)
+    {
+        runHeadless(headlessTicks, replayPath != nullptr ? &replay : nullptr);
+
+        quitGame();
+
+        return getAllocationTestStatus(allocationTracker);
+    }
+
+    // render() draws one snapshot while the simulation thread fills the other, the screen shows
+    // the state one frame behind the simulation in exchange for update and render overlapping.
+    RenderSnapshot snapshots[2];
+    int renderedSnapshot = 0;
+
+    captureRenderSnapshot(snapshots[renderedSnapshot], 0.0f);
 
-    // Activating random seed
-    srand(time(NULL));
+    SimulationFrame simulationFrame;
+
+    startSimulationThread(simulationThread, runSimulationFrame, &simulationFrame);
+
+    startFrameTimer(frameTimer);
+
+    float frameTime = 0.0f;
+
+    // simulation time not consumed by a fixed tick yet, carried over to the next frame.
+    float accumulator = 0.0f;
 
     while (true)
     {
-        currentFrameTime = SDL_GetTicks();
-        deltaTime = (currentFrameTime - previousFrameTime) / 1000.0f;
-        previousFrameTime = currentFrameTime;
+        frameTime = tickFrameTimer(frameTimer);
 
-        handleEvents();
+        beginProfilerFrame(profiler);
+        beginAllocationFrame(allocationTracker);
+        resetFrameArena(frameArena);
 
-        // this is failling when the player dies.
-        if (aliens.size() == 0 || player.lives == 0)
+        // after a stall only simulate a bounded amount of time instead of trying to catch up.
+        if (frameTime > MAX_FRAME_TIME)
         {
-            isGameOver = true;
+            frameTime = MAX_FRAME_TIME;
         }
 
+        // the simulation thread is idle here, events may still reset the game.
+        handleEvents();
+
+        int ticks = 0;
+
         if (!isGamePaused && !isGameOver)
         {
-            update(deltaTime);
+            accumulator += frameTime;
+
+            while (accumulator >= FIXED_DELTA_TIME)
+            {
+                accumulator -= FIXED_DELTA_TIME;
+                ticks++;
+            }
         }
 
-        render();
+        simulationFrame.ticks = ticks;
+        simulationFrame.input = readKeyboardInput();
+        simulationFrame.alpha = accumulator / FIXED_DELTA_TIME;
+        simulationFrame.snapshot = &snapshots[1 - renderedSnapshot];
+
+        kickSimulationThread(simulationThread);
+
+        render(snapshots[renderedSnapshot]);
+
+        waitForSimulationThread(simulationThread);
+
+        // ticks cut off by a game over stay in the accumulator for after the restart.
+        accumulator += (ticks - simulationFrame.ticksRun) * FIXED_DELTA_TIME;
+
+        renderedSnapshot = 1 - renderedSnapshot;
+
+        // all sounds of the frame go out together, so repeats within the frame get merged.
+        flushSoundEvents(audioQueue);
     }
 
     quitGame();
@@ -0,0 +1,395 @@
+#include "music_stream.h"
+#include <algorithm>
+
+// "RIFF", "WAVE", "fmt " and "data" in little endian.
+const Uint32 WAV_RIFF = 0x46464952;
+const Uint32 WAV_WAVE = 0x45564157;
+const Uint32 WAV_FORMAT_CHUNK = 0x20746D66;
+const Uint32 WAV_DATA_CHUNK = 0x61746164;
+
+const Uint16 WAV_PCM = 1;
+const Uint16 WAV_FLOAT = 3;
+const Uint16 WAV_EXTENSIBLE = 0xFFFE;
+
+// how long the reader sleeps while the ring is still mostly full.
+const Uint32 MUSIC_POLL_MILLISECONDS = 10;
+
+static Uint16 getWavAudioFormat(Uint16 formatTag, Uint16 bitsPerSample)
+{
+    if (formatTag == WAV_FLOAT && bitsPerSample == 32)
+    {
+        return AUDIO_F32LSB;
+    }
+
+    if (formatTag != WAV_PCM)
+    {
+        return 0;
+    }
+
+    switch (bitsPerSample)
+    {
+    case 8:
+        return AUDIO_U8;
+    case 16:
+        return AUDIO_S16LSB;
+    case 32:
+        return AUDIO_S32LSB;
+    default:
+        return 0;
+    }
+}
+
+// Reads the sample format from the fmt chunk and stops at the start of the data chunk.
+static bool readWavHeader(MusicStream &stream, SDL_AudioSpec &spec)
+{
+    if (SDL_ReadLE32(stream.file) != WAV_RIFF)
+    {
+        return false;
+    }
+
+    SDL_ReadLE32(stream.file);
+
+    if (SDL_ReadLE32(stream.file) != WAV_WAVE)
+    {
+        return false;
+    }
+
+    spec.format = 0;
+
+    Sint64 fileSize = SDL_RWsize(stream.file);
+
+    while (true)
+    {
+        // a file without a data chunk ends here instead of rereading the same short header forever.
+        Sint64 headerStart = SDL_RWtell(stream.file);
+
+        if (headerStart < 0 || headerStart + 8 > fileSize)
+        {
+            return false;
+        }
+
+        Uint32 chunkId = SDL_ReadLE32(stream.file);
+        Uint32 chunkSize = SDL_ReadLE32(stream.file);
+        Sint64 chunkStart = SDL_RWtell(stream.file);
+
+        if (chunkStart < 0 || chunkStart + chunkSize > fileSize)
+        {
+            return false;
+        }
+
+        if (chunkId == WAV_DATA_CHUNK)
+        {
+            stream.dataStart = chunkStart;
+            stream.dataSize = chunkSize;
+
+            return spec.format != 0;
+        }
+
+        if (chunkId == WAV_FORMAT_CHUNK && chunkSize >= 16)
+        {
+            Uint16 formatTag = SDL_ReadLE16(stream.file);
+            spec.channels = (Uint8)SDL_ReadLE16(stream.file);
+            spec.freq = (int)SDL_ReadLE32(stream.file);
+            // byte rate and block align follow from the rest.
+            SDL_ReadLE32(stream.file);
+            SDL_ReadLE16(stream.file);
+            Uint16 bitsPerSample = SDL_ReadLE16(stream.file);
+
+            // the real format tag sits in the first two bytes of the sub format GUID.
+            if (formatTag == WAV_EXTENSIBLE && chunkSize >= 40)
+            {
+                SDL_RWseek(stream.file, chunkStart + 24, RW_SEEK_SET);
+                formatTag = SDL_ReadLE16(stream.file);
+            }
+
+            spec.format = getWavAudioFormat(formatTag, bitsPerSample);
+
+            if (spec.format == 0 || spec.channels == 0)
+            {
+                return false;
+            }
+        }
+
+        // chunks are padded to an even size.
+        SDL_RWseek(stream.file, chunkStart + chunkSize + (chunkSize & 1), RW_SEEK_SET);
+    }
+}
+
+// Reads up to size bytes of samples, starting over at the end of a looping track.
+static size_t readTrack(MusicStream &stream, Uint8 *destination, size_t size)
+{
+    size_t total = 0;
+
+    while (total < size && stream.dataSize > 0)
+    {
+        if (stream.dataPosition == stream.dataSize)
+        {
+            if (!stream.isLooping)
+            {
+                break;
+            }
+
+            SDL_RWseek(stream.file, stream.dataStart, RW_SEEK_SET);
+            stream.dataPosition = 0;
+        }
+
+        size_t wanted = (size_t)std::min<Sint64>(size - total, stream.dataSize - stream.dataPosition);
+        size_t read = SDL_RWread(stream.file, destination + total, 1, wanted);
+
+        if (read == 0)
+        {
+            break;
+        }
+
+        total += read;
+        stream.dataPosition += read;
+    }
+
+    return total;
+}
+
+// Fills the free part of the ring, returns how many bytes were added.
+static Uint32 fillMusicRing(MusicStream &stream)
+{
+    Uint32 head = stream.head.load(std::memory_order_relaxed);
+    Uint32 tail = stream.tail.load(std::memory_order_acquire);
+    Uint32 ringSize = (Uint32)stream.ring.size();
+    Uint32 space = ringSize - (head - tail);
+    Uint32 frameSize = stream.frameSize;
+
+    Uint32 written = 0;
+
+    if (stream.converter == nullptr)
+    {
+        Uint32 offset = head & stream.ringMask;
+        Uint32 span = std::min(space, ringSize - offset);
+
+        written = (Uint32)readTrack(stream, &stream.ring[offset], span - span % frameSize);
+
+        if (written == 0 && span >= frameSize)
+        {
+            stream.isFinished.store(true, std::memory_order_release);
+        }
+    }
+    else
+    {
+        // only feed the converter what the ring can take, so it never buffers the whole track.
+        if (SDL_AudioStreamAvailable(stream.converter) < (int)space)
+        {
+            size_t read = readTrack(stream, stream.readBuffer.data(), stream.readBuffer.size());
+
+            if (read > 0)
+            {
+                SDL_AudioStreamPut(stream.converter, stream.readBuffer.data(), (int)read);
+            }
+            else
+            {
+                SDL_AudioStreamFlush(stream.converter);
+            }
+        }
+
+        // the free part of the ring can wrap around, so it takes up to two reads.
+        for (int part = 0; part < 2 && written < space; part++)
+        {
+            Uint32 offset = (head + written) & stream.ringMask;
+            Uint32 span = std::min(space - written, ringSize - offset);
+            int converted = SDL_AudioStreamGet(stream.converter, &stream.ring[offset], (int)(span - span % frameSize));
+
+            if (converted <= 0)
+            {
+                break;
+            }
+
+            written += (Uint32)converted;
+        }
+
+        if (written == 0 && space >= frameSize && stream.dataPosition == stream.dataSize && !stream.isLooping && SDL_AudioStreamAvailable(stream.converter) == 0)
+        {
+            stream.isFinished.store(true, std::memory_order_release);
+        }
+    }
+
+    stream.head.store(head + written, std::memory_order_release);
+
+    return written;
+}
+
+static int readMusicStream(void *data)
+{
+    MusicStream &stream = *(MusicStream *)data;
+
+    while (stream.isRunning.load(std::memory_order_acquire))
+    {
+        Uint32 fill = stream.head.load(std::memory_order_relaxed) - stream.tail.load(std::memory_order_acquire);
+
+        // refill in quarter-ring steps instead of topping up after every mixer callback.
+        if (stream.isFinished.load(std::memory_order_relaxed) || fill > stream.ring.size() * 3 / 4 || fillMusicRing(stream) == 0)
+        {
+            SDL_Delay(MUSIC_POLL_MILLISECONDS);
+        }
+    }
+
+    return 0;
+}
+
+// Runs on the mixer's thread, which hands in a silent buffer to mix the music into.
+static void mixMusicStream(void *data, Uint8 *output, int length)
+{
+    MusicStream &stream = *(MusicStream *)data;
+
+    Uint32 tail = stream.tail.load(std::memory_order_relaxed);
+    Uint32 available = stream.head.load(std::memory_order_acquire) - tail;
+
+    stream.lowestFill = std::min(stream.lowestFill, available);
+
+    Uint32 mixed = std::min(available, (Uint32)length);
+
+    if (mixed < (Uint32)length && !stream.isFinished.load(std::memory_order_acquire))
+    {
+        stream.underruns++;
+    }
+
+    // mixing straight out of the ring applies the volume without another copy.
+    Uint32 offset = tail & stream.ringMask;
+    Uint32 firstPart = std::min(mixed, (Uint32)stream.ring.size() - offset);
+
+    SDL_MixAudioFormat(output, &stream.ring[offset], stream.outputFormat, firstPart, stream.volume);
+    SDL_MixAudioFormat(output + firstPart, &stream.ring[0], stream.outputFormat, mixed - firstPart, stream.volume);
+
+    stream.tail.store(tail + mixed, std::memory_order_release);
+}
+
+bool openMusicStream(MusicStream &stream, const char *filePath, int bufferMilliseconds, bool isLooping)
+{
+    stream.file = SDL_RWFromFile(filePath, "rb");
+
+    if (stream.file == nullptr)
+    {
+        printf("Failed to load music! SDL Error: %s\n", SDL_GetError());
+        return false;
+    }
+
+    SDL_AudioSpec spec = {};
+
+    if (!readWavHeader(stream, spec))
+    {
+        printf("Failed to load music! %s is not a PCM WAV file\n", filePath);
+        closeMusicStream(stream);
+
+        return false;
+    }
+
+    int frequency = 0;
+    Uint16 format = 0;
+    int channels = 0;
+
+    if (Mix_QuerySpec(&frequency, &format, &channels) == 0 || channels != 2)
+    {
+        printf("Failed to load music! The mixer is not open in stereo\n");
+        closeMusicStream(stream);
+
+        return false;
+    }
+
+    stream.converter = nullptr;
+
+    if (spec.format != format || spec.channels != channels || spec.freq != frequency)
+    {
+        stream.converter = SDL_NewAudioStream(spec.format, spec.channels, spec.freq, format, channels, frequency);
+
+        if (stream.converter == nullptr)
+        {
+            printf("Failed to load music! SDL Error: %s\n", SDL_GetError());
+            closeMusicStream(stream);
+
+            return false;
+        }
+    }
+
+    stream.outputFormat = format;
+    stream.frameSize = (Uint32)(channels * SDL_AUDIO_BITSIZE(format) / 8);
+    stream.bytesPerSecond = frequency * (int)stream.frameSize;
+    stream.isLooping = isLooping;
+
+    // a power of two ring, so positions wrap with a mask.
+    Uint32 ringSize = 4096;
+
+    while (ringSize < (Uint64)stream.bytesPerSecond * bufferMilliseconds / 1000)
+    {
+        ringSize *= 2;
+    }
+
+    stream.ring.assign(ringSize, 0);
+    stream.ringMask = ringSize - 1;
+
+    if (stream.converter != nullptr)
+    {
+        int sourceFrameSize = SDL_AUDIO_BITSIZE(spec.format) / 8 * spec.channels;
+        stream.readBuffer.resize(ringSize / 4 / sourceFrameSize * sourceFrameSize + sourceFrameSize);
+    }
+
+    SDL_RWseek(stream.file, stream.dataStart, RW_SEEK_SET);
+    stream.dataPosition = 0;
+
+    stream.head.store(0);
+    stream.tail.store(0);
+    stream.isFinished.store(false);
+    stream.underruns = 0;
+    stream.lowestFill = ringSize;
+
+    return true;
+}
+
+void playMusicStream(MusicStream &stream, int volume)
+{
+    stream.volume = volume;
+
+    // start with a full ring, so the first callbacks do not count as underruns.
+    while (fillMusicRing(stream) > 0)
+    {
+    }
+
+    stream.isRunning.store(true);
+
+    stream.thread = SDL_CreateThread(readMusicStream, "music stream", &stream);
+
+    if (stream.thread == nullptr)
+    {
+        printf("Failed to start the music thread: %s\n", SDL_GetError());
+        stream.isRunning.store(false);
+
+        return;
+    }
+
+    Mix_HookMusic(mixMusicStream, &stream);
+}
+
+void closeMusicStream(MusicStream &stream)
+{
+    if (stream.file == nullptr)
+    {
+        return;
+    }
+
+    if (stream.thread != nullptr)
+    {
+        // takes the audio lock, no callback runs once the hook is gone.
+        Mix_HookMusic(nullptr, nullptr);
+
+        stream.isRunning.store(false, std::memory_order_release);
+
+        SDL_WaitThread(stream.thread, nullptr);
+        stream.thread = nullptr;
+
+        printf("Music: %d ms buffer, %d underruns, lowest fill %d ms\n", (int)((Uint64)stream.ring.size() * 1000 / stream.bytesPerSecond), stream.underruns, (int)((Uint64)stream.lowestFill * 1000 / stream.bytesPerSecond));
+    }
+
+    if (stream.converter != nullptr)
+    {
+        SDL_FreeAudioStream(stream.converter);
+        stream.converter = nullptr;
+    }
+
+    SDL_RWclose(stream.file);
+    stream.file = nullptr;
+}
@@ -0,0 +1,215 @@
+#include "profiler.h"
+
+const char *PROFILE_PHASE_NAMES[PROFILE_PHASE_COUNT] = {"handleEvents", "update", "aliensMovement", "removeDestroyedElements", "render"};
+
+thread_local int currentProfilePhase = -1;
+
+// one color per phase, shared by the bars and the text line of the phase.
+const SDL_Color PROFILE_PHASE_COLORS[PROFILE_PHASE_COUNT] = {{90, 160, 255, 255}, {90, 220, 120, 255}, {255, 210, 70, 255}, {255, 130, 70, 255}, {220, 100, 220, 255}};
+
+// the bar graph shows every kept frame PROFILE_BAR_WIDTH pixels wide, its full height is PROFILE_GRAPH_MILLISECONDS.
+const int PROFILE_BAR_WIDTH = 4;
+const int PROFILE_GRAPH_HEIGHT = 100;
+const double PROFILE_GRAPH_MILLISECONDS = 33.3;
+const double PROFILE_BUDGET_MILLISECONDS = 1000.0 / 60;
+
+void startProfiler(Profiler &profiler, bool isEnabled)
+{
+    profiler.isEnabled = isEnabled;
+    profiler.frequency = SDL_GetPerformanceFrequency();
+    profiler.startCounter = SDL_GetPerformanceCounter();
+    profiler.mainThread = SDL_ThreadID();
+    profiler.frame = 0;
+
+    SDL_AtomicSet(&profiler.writtenEvents, 0);
+
+    SDL_memset(profiler.frameTimes, 0, sizeof(profiler.frameTimes));
+}
+
+void beginProfilerFrame(Profiler &profiler)
+{
+    if (!profiler.isEnabled)
+    {
+        return;
+    }
+
+    profiler.frame++;
+
+    SDL_memset(profiler.frameTimes[profiler.frame % PROFILER_FRAMES], 0, sizeof(profiler.frameTimes[0]));
+}
+
+void addProfileEvent(Profiler &profiler, ProfilePhase phase, Uint64 start, Uint64 end)
+{
+    Uint64 duration = end - start;
+
+    profiler.frameTimes[profiler.frame % PROFILER_FRAMES][phase] += duration;
+
+    Uint8 thread = SDL_ThreadID() == profiler.mainThread ? 1 : 2;
+    int event = SDL_AtomicAdd(&profiler.writtenEvents, 1);
+
+    profiler.events[(Uint32)event % PROFILER_EVENTS] = {(Uint8)phase, thread, start, duration};
+}
+
+// aliensMovement and removeDestroyedElements are timed inside update, stacking them on top of it would count them twice.
+static bool isNestedInUpdate(int phase)
+{
+    return phase == PROFILE_ALIENS_MOVEMENT || phase == PROFILE_REMOVE_DESTROYED;
+}
+
+static int toGraphPixels(double milliseconds)
+{
+    return (int)(milliseconds * PROFILE_GRAPH_HEIGHT / PROFILE_GRAPH_MILLISECONDS);
+}
+
+static void fillGraphBar(SDL_Renderer *renderer, const SDL_Rect &graph, int x, int bottom, int height, SDL_Color color)
+{
+    // anything past the top of the graph is cut off.
+    height = SDL_min(height, bottom - graph.y);
+
+    if (height <= 0)
+    {
+        return;
+    }
+
+    SDL_Rect bar = {x, bottom - height, PROFILE_BAR_WIDTH - 1, height};
+
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+    SDL_RenderFillRect(renderer, &bar);
+}
+
+// One stacked bar per finished frame, newest on the right: handleEvents, update and render on top of
+// each other, with the phases nested in update drawn over the bottom of update's segment.
+static void renderProfilerGraph(SDL_Renderer *renderer, const Profiler &profiler, const SDL_Rect &graph, int totalFrames)
+{
+    for (int i = 1; i <= totalFrames; i++)
+    {
+        const Uint64 *times = profiler.frameTimes[(profiler.frame - i) % PROFILER_FRAMES];
+
+        int x = graph.x + graph.w - i * PROFILE_BAR_WIDTH;
+        int bottom = graph.y + graph.h;
+
+        for (int phase = 0; phase < PROFILE_PHASE_COUNT; phase++)
+        {
+            if (isNestedInUpdate(phase))
+            {
+                continue;
+            }
+
+            int height = toGraphPixels((double)times[phase] * 1000 / profiler.frequency);
+
+            fillGraphBar(renderer, graph, x, bottom, height, PROFILE_PHASE_COLORS[phase]);
+
+            if (phase == PROFILE_UPDATE)
+            {
+                int nestedBottom = bottom;
+
+                for (int nested = 0; nested < PROFILE_PHASE_COUNT; nested++)
+                {
+                    if (isNestedInUpdate(nested))
+                    {
+                        int nestedHeight = toGraphPixels((double)times[nested] * 1000 / profiler.frequency);
+
+                        fillGraphBar(renderer, graph, x, nestedBottom, nestedHeight, PROFILE_PHASE_COLORS[nested]);
+
+                        nestedBottom -= nestedHeight;
+                    }
+                }
+            }
+
+            bottom -= height;
+        }
+    }
+
+    // the 60 fps budget.
+    int budgetY = graph.y + graph.h - toGraphPixels(PROFILE_BUDGET_MILLISECONDS);
+
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 120);
+    SDL_RenderDrawLine(renderer, graph.x, budgetY, graph.x + graph.w - 1, budgetY);
+}
+
+void renderProfilerOverlay(SDL_Renderer *renderer, const Profiler &profiler, const GlyphAtlas &atlas)
+{
+    if (!profiler.isEnabled)
+    {
+        return;
+    }
+
+    // the frame being recorded is incomplete, only the finished ones are averaged.
+    int totalFrames = SDL_min(profiler.frame, PROFILER_FRAMES - 1);
+
+    SDL_Rect background = {10, 60, 520, atlas.lineHeight * PROFILE_PHASE_COUNT + 10};
+    SDL_Rect graph = {background.x, background.y + background.h + 5, background.w, PROFILE_GRAPH_HEIGHT};
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+    SDL_RenderFillRect(renderer, &background);
+    SDL_RenderFillRect(renderer, &graph);
+
+    renderProfilerGraph(renderer, profiler, graph, totalFrames);
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+    char line[64];
+
+    for (int phase = 0; phase < PROFILE_PHASE_COUNT; phase++)
+    {
+        Uint64 total = 0;
+        Uint64 worst = 0;
+
+        for (int i = 1; i <= totalFrames; i++)
+        {
+            Uint64 time = profiler.frameTimes[(profiler.frame - i) % PROFILER_FRAMES][phase];
+
+            total += time;
+            worst = SDL_max(worst, time);
+        }
+
+        double average = totalFrames > 0 ? (double)total / totalFrames : 0;
+
+        SDL_snprintf(line, sizeof(line), "%s %.2f/%.2f ms", PROFILE_PHASE_NAMES[phase], average * 1000 / profiler.frequency, (double)worst * 1000 / profiler.frequency);
+
+        // the line doubles as the legend of the graph.
+        SDL_SetTextureColorMod(atlas.texture, PROFILE_PHASE_COLORS[phase].r, PROFILE_PHASE_COLORS[phase].g, PROFILE_PHASE_COLORS[phase].b);
+
+        renderText(renderer, atlas, line, background.x + 5, background.y + 5 + phase * atlas.lineHeight);
+    }
+
+    SDL_SetTextureColorMod(atlas.texture, 255, 255, 255);
+}
+
+bool exportChromeTrace(const Profiler &profiler, const char *filePath)
+{
+    Uint32 writtenEvents = (Uint32)SDL_AtomicGet((SDL_atomic_t *)&profiler.writtenEvents);
+    int eventCount = (int)SDL_min(writtenEvents, (Uint32)PROFILER_EVENTS);
+    Uint32 firstEvent = (writtenEvents - eventCount) % PROFILER_EVENTS;
+
+    FILE *file = fopen(filePath, "w");
+
+    if (file == nullptr)
+    {
+        printf("Failed to write trace %s\n", filePath);
+        return false;
+    }
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"main\"}},\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"simulation\"}}%s\n", eventCount > 0 ? "," : "");
+
+    for (int i = 0; i < eventCount; i++)
+    {
+        const ProfileEvent &event = profiler.events[(firstEvent + i) % PROFILER_EVENTS];
+
+        // trace timestamps are microseconds.
+        double start = (double)(event.start - profiler.startCounter) * 1000000 / profiler.frequency;
+        double duration = (double)event.duration * 1000000 / profiler.frequency;
+
+        fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}%s\n", PROFILE_PHASE_NAMES[event.phase], start, duration, event.thread, i + 1 < eventCount ? "," : "");
+    }
+
+    fprintf(file, "]}\n");
+    fclose(file);
+
+    printf("Wrote %d profile events to %s\n", eventCount, filePath);
+
+    return true;
+}
@@ -11,14 +11,16 @@ Sprite loadSprite(SDL_Renderer *renderer, const char *filePath, int positionX, i
         SDL_QueryTexture(texture, NULL, NULL, &textureBounds.w, &textureBounds.h);
     }
 
-    Sprite sprite = {texture, textureBounds}; 
+    SDL_Rect sourceBounds = {0, 0, textureBounds.w, textureBounds.h};
+
+    Sprite sprite = {texture, textureBounds, sourceBounds};
 
     return sprite;
 }
 
 void renderSprite(SDL_Renderer *renderer, Sprite &sprite)
 {
-    SDL_RenderCopy(renderer, sprite.texture, NULL, &sprite.textureBounds);
+    SDL_RenderCopy(renderer, sprite.texture, &sprite.sourceBounds, &sprite.textureBounds);
 }
 
 Mix_Chunk *loadSound(const char *filePath)
@@ -1,6 +1,6 @@
 #include "sdl_starter.h"
 
-int startSDL(SDL_Window *window, SDL_Renderer *renderer)
+int startSDL(SDL_Window *window, SDL_Renderer *renderer, int audioBufferSamples)
 {
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0)
     {
@@ -30,16 +30,40 @@ int startSDL(SDL_Window *window, SDL_Renderer *renderer)
     }
 
     // Initialize SDL_mixer
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0)
+    if (Mix_OpenAudio(AUDIO_FREQUENCY, AUDIO_FORMAT, AUDIO_CHANNELS, audioBufferSamples) < 0)
     {
         printf("SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError());
         return 1;
     }
 
+    printf("Audio buffer: %d samples, %.1f ms latency\n", audioBufferSamples, audioBufferSamples * 1000.0f / AUDIO_FREQUENCY);
+
     if (TTF_Init() == -1)
     {
         return 1;
     }
 
+    return 0;
+}
+
+int startHeadlessSDL()
+{
+    // dummy drivers, so the simulation also runs on machines without a display or a sound card.
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        std::cout << "SDL crashed. Error: " << SDL_GetError();
+        return 1;
+    }
+
+    // only used to read the sprite sizes, nothing is uploaded.
+    if (!IMG_Init(IMG_INIT_PNG))
+    {
+        std::cout << "SDL_image crashed. Error: " << SDL_GetError();
+        return 1;
+    }
+
     return 0;
 }
\ No newline at end of file
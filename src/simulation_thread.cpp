@@ -0,0 +1,97 @@
+#include "simulation_thread.h"
+
+static int runSimulationThread(void *data)
+{
+    SimulationThread &simulation = *(SimulationThread *)data;
+
+    while (true)
+    {
+        SDL_SemWait(simulation.startSignal);
+
+        if (simulation.isStopping)
+        {
+            break;
+        }
+
+        simulation.job(simulation.data);
+
+        SDL_SemPost(simulation.doneSignal);
+    }
+
+    return 0;
+}
+
+bool startSimulationThread(SimulationThread &simulation, void (*job)(void *data), void *data)
+{
+    simulation.job = job;
+    simulation.data = data;
+    simulation.isStopping = false;
+    simulation.isBusy = false;
+
+    simulation.startSignal = SDL_CreateSemaphore(0);
+    simulation.doneSignal = SDL_CreateSemaphore(0);
+
+    simulation.thread = simulation.startSignal != nullptr && simulation.doneSignal != nullptr ? SDL_CreateThread(runSimulationThread, "simulation", &simulation) : nullptr;
+
+    if (simulation.thread == nullptr)
+    {
+        printf("Failed to start the simulation thread: %s\n", SDL_GetError());
+        stopSimulationThread(simulation);
+
+        return false;
+    }
+
+    return true;
+}
+
+void kickSimulationThread(SimulationThread &simulation)
+{
+    // without a thread the job runs right away, the frame is then just not pipelined.
+    if (simulation.thread == nullptr)
+    {
+        simulation.job(simulation.data);
+        return;
+    }
+
+    simulation.isBusy = true;
+
+    SDL_SemPost(simulation.startSignal);
+}
+
+void waitForSimulationThread(SimulationThread &simulation)
+{
+    if (!simulation.isBusy)
+    {
+        return;
+    }
+
+    SDL_SemWait(simulation.doneSignal);
+
+    simulation.isBusy = false;
+}
+
+void stopSimulationThread(SimulationThread &simulation)
+{
+    if (simulation.thread != nullptr)
+    {
+        waitForSimulationThread(simulation);
+
+        simulation.isStopping = true;
+        SDL_SemPost(simulation.startSignal);
+
+        SDL_WaitThread(simulation.thread, nullptr);
+        simulation.thread = nullptr;
+    }
+
+    if (simulation.startSignal != nullptr)
+    {
+        SDL_DestroySemaphore(simulation.startSignal);
+        simulation.startSignal = nullptr;
+    }
+
+    if (simulation.doneSignal != nullptr)
+    {
+        SDL_DestroySemaphore(simulation.doneSignal);
+        simulation.doneSignal = nullptr;
+    }
+}
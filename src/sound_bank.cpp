@@ -0,0 +1,280 @@
+#include "sound_bank.h"
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// "SSBK" in little endian, followed by the format version.
+const Uint32 SOUND_BANK_MAGIC = 0x4B425353;
+const Uint32 SOUND_BANK_VERSION = 1;
+
+// magic, version, frequency, format, channels and sound count, then an offset and a length per sound.
+const Uint32 SOUND_BANK_HEADER_SIZE = 6 * 4;
+const Uint32 SOUND_BANK_ENTRY_SIZE = 2 * 4;
+
+// every sound starts on its own 16 byte boundary, so the mixer reads aligned samples.
+const Uint32 SOUND_BANK_ALIGNMENT = 16;
+
+static Uint32 readBankU32(const SoundBank &bank, size_t offset)
+{
+    Uint32 value;
+    SDL_memcpy(&value, bank.data + offset, sizeof(value));
+
+    return SDL_SwapLE32(value);
+}
+
+static bool convertSound(const char *filePath, std::vector<Uint8> &pcm, int frequency, Uint16 format, int channels)
+{
+    SDL_AudioSpec spec;
+    Uint8 *wavData = nullptr;
+    Uint32 wavLength = 0;
+
+    if (SDL_LoadWAV(filePath, &spec, &wavData, &wavLength) == nullptr)
+    {
+        printf("Failed to decode %s! SDL Error: %s\n", filePath, SDL_GetError());
+        return false;
+    }
+
+    SDL_AudioCVT converter;
+
+    if (SDL_BuildAudioCVT(&converter, spec.format, spec.channels, spec.freq, format, channels, frequency) < 0)
+    {
+        printf("Failed to convert %s! SDL Error: %s\n", filePath, SDL_GetError());
+        SDL_FreeWAV(wavData);
+
+        return false;
+    }
+
+    // the conversion runs in place, the buffer needs room for the converted samples.
+    pcm.assign((size_t)wavLength * converter.len_mult, 0);
+    SDL_memcpy(pcm.data(), wavData, wavLength);
+    SDL_FreeWAV(wavData);
+
+    converter.buf = pcm.data();
+    converter.len = (int)wavLength;
+
+    if (converter.needed && SDL_ConvertAudio(&converter) < 0)
+    {
+        printf("Failed to convert %s! SDL Error: %s\n", filePath, SDL_GetError());
+        return false;
+    }
+
+    pcm.resize(converter.needed ? converter.len_cvt : wavLength);
+
+    return true;
+}
+
+bool bakeSoundBank(const char *const *filePaths, int count, const char *bankPath, int frequency, Uint16 format, int channels)
+{
+    std::vector<std::vector<Uint8>> sounds(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        if (!convertSound(filePaths[i], sounds[i], frequency, format, channels))
+        {
+            return false;
+        }
+    }
+
+    SDL_RWops *file = SDL_RWFromFile(bankPath, "wb");
+
+    if (file == nullptr)
+    {
+        printf("Failed to save sound bank %s! SDL Error: %s\n", bankPath, SDL_GetError());
+        return false;
+    }
+
+    SDL_WriteLE32(file, SOUND_BANK_MAGIC);
+    SDL_WriteLE32(file, SOUND_BANK_VERSION);
+    SDL_WriteLE32(file, (Uint32)frequency);
+    SDL_WriteLE32(file, format);
+    SDL_WriteLE32(file, (Uint32)channels);
+    SDL_WriteLE32(file, (Uint32)count);
+
+    Uint32 offset = SOUND_BANK_HEADER_SIZE + SOUND_BANK_ENTRY_SIZE * count;
+    std::vector<Uint32> offsets(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        offset = (offset + SOUND_BANK_ALIGNMENT - 1) & ~(SOUND_BANK_ALIGNMENT - 1);
+        offsets[i] = offset;
+
+        SDL_WriteLE32(file, offset);
+        SDL_WriteLE32(file, (Uint32)sounds[i].size());
+
+        offset += (Uint32)sounds[i].size();
+    }
+
+    Uint32 position = SOUND_BANK_HEADER_SIZE + SOUND_BANK_ENTRY_SIZE * count;
+    const Uint8 padding[SOUND_BANK_ALIGNMENT] = {0};
+
+    for (int i = 0; i < count; i++)
+    {
+        SDL_RWwrite(file, padding, 1, offsets[i] - position);
+        SDL_RWwrite(file, sounds[i].data(), 1, sounds[i].size());
+
+        position = offsets[i] + (Uint32)sounds[i].size();
+    }
+
+    SDL_RWclose(file);
+
+    printf("Baked %d sounds into %s, %u bytes at %d Hz\n", count, bankPath, position, frequency);
+
+    return true;
+}
+
+static bool mapSoundBank(SoundBank &bank, const char *bankPath)
+{
+#ifdef _WIN32
+    bank.file = CreateFileA(bankPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (bank.file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(bank.file, &fileSize);
+    bank.size = (size_t)fileSize.QuadPart;
+
+    bank.mapping = bank.size > 0 ? CreateFileMappingA(bank.file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    bank.data = bank.mapping != NULL ? (Uint8 *)MapViewOfFile(bank.mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+#else
+    int file = open(bankPath, O_RDONLY);
+
+    if (file == -1)
+    {
+        return false;
+    }
+
+    struct stat fileStat;
+    bank.size = fstat(file, &fileStat) == 0 ? (size_t)fileStat.st_size : 0;
+
+    void *data = bank.size > 0 ? mmap(nullptr, bank.size, PROT_READ, MAP_PRIVATE, file, 0) : MAP_FAILED;
+    bank.data = data != MAP_FAILED ? (Uint8 *)data : nullptr;
+
+    // the mapping keeps the file alive on its own.
+    close(file);
+#endif
+
+    if (bank.data == nullptr)
+    {
+        closeSoundBank(bank);
+        return false;
+    }
+
+    return true;
+}
+
+bool openSoundBank(SoundBank &bank, const char *bankPath)
+{
+    if (!mapSoundBank(bank, bankPath))
+    {
+        printf("Failed to map sound bank %s\n", bankPath);
+        return false;
+    }
+
+    if (bank.size < SOUND_BANK_HEADER_SIZE || readBankU32(bank, 0) != SOUND_BANK_MAGIC || readBankU32(bank, 4) != SOUND_BANK_VERSION)
+    {
+        printf("%s is not a sound bank of version %u\n", bankPath, SOUND_BANK_VERSION);
+        closeSoundBank(bank);
+
+        return false;
+    }
+
+    bank.frequency = (int)readBankU32(bank, 8);
+    bank.format = (Uint16)readBankU32(bank, 12);
+    bank.channels = (int)readBankU32(bank, 16);
+    bank.soundCount = (int)readBankU32(bank, 20);
+
+    size_t tableEnd = SOUND_BANK_HEADER_SIZE + (size_t)SOUND_BANK_ENTRY_SIZE * bank.soundCount;
+    bool isValid = tableEnd <= bank.size;
+
+    for (int i = 0; isValid && i < bank.soundCount; i++)
+    {
+        size_t entry = SOUND_BANK_HEADER_SIZE + (size_t)SOUND_BANK_ENTRY_SIZE * i;
+        isValid = (size_t)readBankU32(bank, entry) + readBankU32(bank, entry + 4) <= bank.size;
+    }
+
+    if (!isValid)
+    {
+        printf("Sound bank %s is truncated\n", bankPath);
+        closeSoundBank(bank);
+
+        return false;
+    }
+
+    int frequency = 0;
+    Uint16 format = 0;
+    int channels = 0;
+
+    // the raw chunks are played as they are, a bank baked for another output format would play garbled.
+    if (Mix_QuerySpec(&frequency, &format, &channels) == 0 || frequency != bank.frequency || format != bank.format || channels != bank.channels)
+    {
+        printf("Sound bank %s was baked for another audio format, bake it again\n", bankPath);
+        closeSoundBank(bank);
+
+        return false;
+    }
+
+    return true;
+}
+
+Mix_Chunk *loadBankSound(const SoundBank &bank, int index)
+{
+    if (index < 0 || index >= bank.soundCount)
+    {
+        return nullptr;
+    }
+
+    size_t entry = SOUND_BANK_HEADER_SIZE + (size_t)SOUND_BANK_ENTRY_SIZE * index;
+
+    Mix_Chunk *sound = Mix_QuickLoad_RAW(bank.data + readBankU32(bank, entry), readBankU32(bank, entry + 4));
+
+    if (sound == nullptr)
+    {
+        printf("Failed to load sound %d from the bank! SDL_mixer Error: %s\n", index, Mix_GetError());
+    }
+
+    return sound;
+}
+
+void closeSoundBank(SoundBank &bank)
+{
+#ifdef _WIN32
+    if (bank.data != nullptr)
+    {
+        UnmapViewOfFile(bank.data);
+    }
+
+    if (bank.mapping != NULL)
+    {
+        CloseHandle(bank.mapping);
+    }
+
+    if (bank.file != NULL && bank.file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(bank.file);
+    }
+
+    bank.mapping = NULL;
+    bank.file = NULL;
+#else
+    if (bank.data != nullptr)
+    {
+        munmap(bank.data, bank.size);
+    }
+#endif
+
+    bank.data = nullptr;
+    bank.size = 0;
+    bank.soundCount = 0;
+}
@@ -0,0 +1,99 @@
+#include "sprite_batch.h"
+
+static void useTexture(SpriteBatch &batch, SDL_Texture *texture)
+{
+    if (texture == batch.texture)
+    {
+        return;
+    }
+
+    flushSpriteBatch(batch);
+
+    batch.texture = texture;
+    batch.inverseTextureWidth = 0;
+    batch.inverseTextureHeight = 0;
+
+    int width, height;
+
+    if (texture != nullptr && SDL_QueryTexture(texture, NULL, NULL, &width, &height) == 0)
+    {
+        batch.inverseTextureWidth = 1.0f / width;
+        batch.inverseTextureHeight = 1.0f / height;
+    }
+}
+
+static void addQuad(SpriteBatch &batch, const SDL_Rect &bounds, SDL_Color color, float left, float top, float right, float bottom)
+{
+    float x = (float)bounds.x;
+    float y = (float)bounds.y;
+    float x2 = (float)(bounds.x + bounds.w);
+    float y2 = (float)(bounds.y + bounds.h);
+
+    batch.vertices.push_back({{x, y}, color, {left, top}});
+    batch.vertices.push_back({{x2, y}, color, {right, top}});
+    batch.vertices.push_back({{x2, y2}, color, {right, bottom}});
+    batch.vertices.push_back({{x, y2}, color, {left, bottom}});
+}
+
+void beginSpriteBatch(SpriteBatch &batch, SDL_Renderer *renderer)
+{
+    batch.renderer = renderer;
+    batch.texture = nullptr;
+    batch.inverseTextureWidth = 0;
+    batch.inverseTextureHeight = 0;
+    batch.vertices.clear();
+    batch.drawCalls = 0;
+}
+
+void batchSprite(SpriteBatch &batch, SDL_Texture *texture, const SDL_Rect &sourceBounds, const SDL_Rect &bounds)
+{
+    useTexture(batch, texture);
+
+    float left = sourceBounds.x * batch.inverseTextureWidth;
+    float top = sourceBounds.y * batch.inverseTextureHeight;
+    float right = (sourceBounds.x + sourceBounds.w) * batch.inverseTextureWidth;
+    float bottom = (sourceBounds.y + sourceBounds.h) * batch.inverseTextureHeight;
+
+    addQuad(batch, bounds, {255, 255, 255, 255}, left, top, right, bottom);
+}
+
+void batchSprite(SpriteBatch &batch, const Sprite &sprite)
+{
+    batchSprite(batch, sprite.texture, sprite.sourceBounds, sprite.textureBounds);
+}
+
+void batchRect(SpriteBatch &batch, const SDL_Rect &bounds, SDL_Color color)
+{
+    useTexture(batch, nullptr);
+
+    addQuad(batch, bounds, color, 0, 0, 0, 0);
+}
+
+void flushSpriteBatch(SpriteBatch &batch)
+{
+    int totalVertices = batch.vertices.size();
+
+    if (totalVertices == 0)
+    {
+        return;
+    }
+
+    int totalIndices = totalVertices / 4 * 6;
+
+    for (int quad = batch.indices.size() / 6; quad < totalVertices / 4; quad++)
+    {
+        int first = quad * 4;
+
+        batch.indices.push_back(first);
+        batch.indices.push_back(first + 1);
+        batch.indices.push_back(first + 2);
+        batch.indices.push_back(first);
+        batch.indices.push_back(first + 2);
+        batch.indices.push_back(first + 3);
+    }
+
+    SDL_RenderGeometry(batch.renderer, batch.texture, batch.vertices.data(), totalVertices, batch.indices.data(), totalIndices);
+
+    batch.vertices.clear();
+    batch.drawCalls++;
+}
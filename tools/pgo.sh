@@ -0,0 +1,72 @@
+#!/bin/sh
+# Profile guided optimization pipeline on the CMake presets:
+#   1. build the instrumented game (pgo-generate) and run the bundled training workload, which
+#      records the profile into build/pgo-profile,
+#   2. rebuild with the profile (pgo-use, LTO + PGO),
+#   3. run the training workload on release, lto and pgo-use and compare the tick time percentiles.
+# lto is in the report so the gain of the profile is not mixed up with the gain of LTO alone.
+#
+# usage: tools/pgo.sh [rounds], every configuration is run `rounds` times (default 5), interleaved,
+# and the report keeps the best run of each.
+set -e
+
+cd "$(dirname "$0")/.."
+
+ROUNDS=${1:-5}
+CONFIGURATIONS="release lto pgo-use"
+
+# only the game is trained, so only the game is built with the profile.
+for preset in release lto pgo-generate; do
+    cmake --preset "$preset" > /dev/null
+    cmake --build --preset "$preset" --target main
+done
+
+rm -rf build/pgo-profile
+(cd build/pgo-generate && ./main --training)
+
+# clang writes raw profiles that have to be merged, gcc reads its .gcda files directly.
+if ls build/pgo-profile/*.profraw > /dev/null 2>&1; then
+    llvm-profdata merge -output=build/pgo-profile/default.profdata build/pgo-profile/*.profraw
+fi
+
+cmake --preset pgo-use > /dev/null
+cmake --build --preset pgo-use --target main
+
+rm -f build/pgo-report.txt
+
+round=1
+while [ "$round" -le "$ROUNDS" ]; do
+    for preset in $CONFIGURATIONS; do
+        line=$(cd "build/$preset" && ./main --training | grep '^Training:')
+        echo "$preset round $round: $line"
+        echo "$preset $line" >> build/pgo-report.txt
+    done
+    round=$((round + 1))
+done
+
+# the best run of each configuration is the one with the lowest p50.
+echo
+awk -v configurations="$CONFIGURATIONS" '
+{
+    for (i = 1; i <= NF; i++) {
+        if ($i == "p50" || $i == "p90" || $i == "p99" || $i == "avg") {
+            value[$i] = $(i + 1)
+        }
+    }
+
+    if (!($1 in best) || value["p50"] < best[$1]) {
+        best[$1] = value["p50"]
+        p90[$1] = value["p90"]
+        p99[$1] = value["p99"]
+        average[$1] = value["avg"]
+    }
+}
+END {
+    printf "%-10s %10s %10s %10s %10s %12s\n", "tick (us)", "avg", "p50", "p90", "p99", "p99 vs rel."
+    count = split(configurations, names, " ")
+
+    for (i = 1; i <= count; i++) {
+        name = names[i]
+        printf "%-10s %10.2f %10.2f %10.2f %10.2f %+11.1f%%\n", name, average[name], best[name], p90[name], p99[name], (p99[name] / p99["release"] - 1) * 100
+    }
+}' build/pgo-report.txt